@@ -0,0 +1,109 @@
+// battle_resolver.cpp
+#include "battle_resolver.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <utility>
+
+BattleResolver::Result BattleResolver::resolve(const std::vector<Combatant>& attackers,
+                                               const std::vector<Combatant>& defenders) {
+    Result result;
+    Side attack;
+    Side defend;
+    buildSide(attackers, result.attackerHealth, attack);
+    buildSide(defenders, result.defenderHealth, defend);
+
+    const long long never = std::numeric_limits<long long>::max();
+
+    while (attack.alive > 0 && defend.alive > 0) {
+        pickTarget(attack);
+        pickTarget(defend);
+
+        if (attack.totalAttack == 0 && defend.totalAttack == 0) {
+            result.stalemate = true;
+            break;
+        }
+
+        long long& defenderTargetHealth = (*defend.health)[defend.target];
+        long long& attackerTargetHealth = (*attack.health)[attack.target];
+
+        // Rounds until each side's focused target dies, if nothing else changes.
+        long long roundsToKillDefender = attack.totalAttack > 0
+            ? (defenderTargetHealth + attack.totalAttack - 1) / attack.totalAttack : never;
+        long long roundsToKillAttacker = defend.totalAttack > 0
+            ? (attackerTargetHealth + defend.totalAttack - 1) / defend.totalAttack : never;
+
+        // Skip straight to the round in which the first ship dies.
+        long long quietRounds = std::min(roundsToKillDefender, roundsToKillAttacker) - 1;
+        if (quietRounds > 0) {
+            defenderTargetHealth -= quietRounds * attack.totalAttack;
+            attackerTargetHealth -= quietRounds * defend.totalAttack;
+            result.rounds += quietRounds;
+        }
+
+        // Play the deciding round in full: a defender killed by the attackers does not fire back.
+        defenderTargetHealth -= attack.totalAttack;
+        bool defenderKilled = defenderTargetHealth <= 0;
+        long long returnFire = defend.totalAttack - (defenderKilled ? defend.targetAttack : 0);
+        attackerTargetHealth -= returnFire;
+        bool attackerKilled = attackerTargetHealth <= 0;
+        ++result.rounds;
+
+        if (defenderKilled) {
+            removeTarget(defend);
+        }
+        if (attackerKilled) {
+            removeTarget(attack);
+        }
+    }
+
+    return result;
+}
+
+void BattleResolver::buildSide(const std::vector<Combatant>& ships, std::vector<long long>& health, Side& side) {
+    std::map<std::pair<int, int>, std::size_t> stackOf;
+    health.resize(ships.size());
+    side.health = &health;
+
+    for (std::size_t i = 0; i < ships.size(); ++i) {
+        const Combatant& ship = ships[i];
+        health[i] = ship.health;
+        side.totalAttack += ship.attackPower;
+        ++side.alive;
+
+        auto found = stackOf.find(std::make_pair(ship.health, ship.attackPower));
+        if (found == stackOf.end()) {
+            found = stackOf.emplace(std::make_pair(ship.health, ship.attackPower), side.stacks.size()).first;
+            side.stacks.push_back(Stack{ship.health, ship.attackPower, std::vector<int>(), 0});
+        }
+        side.stacks[found->second].members.push_back(static_cast<int>(i));
+    }
+}
+
+// The damaged target stays the weakest ship until it dies, so a new one is only
+// picked from the untouched stacks: the lowest health, then the earliest to join.
+void BattleResolver::pickTarget(Side& side) {
+    if (side.target >= 0 || side.alive == 0) {
+        return;
+    }
+    Stack* weakest = nullptr;
+    for (Stack& stack : side.stacks) {
+        if (stack.next == stack.members.size()) {
+            continue;
+        }
+        if (weakest == nullptr || stack.health < weakest->health ||
+            (stack.health == weakest->health && stack.members[stack.next] < weakest->members[weakest->next])) {
+            weakest = &stack;
+        }
+    }
+    side.target = weakest->members[weakest->next++];
+    side.targetAttack = weakest->attackPower;
+}
+
+void BattleResolver::removeTarget(Side& side) {
+    side.totalAttack -= side.targetAttack;
+    --side.alive;
+    side.target = -1;
+    side.targetAttack = 0;
+}
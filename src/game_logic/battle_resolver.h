@@ -0,0 +1,61 @@
+// battle_resolver.h
+#ifndef BATTLE_RESOLVER_H
+#define BATTLE_RESOLVER_H
+
+#include <cstddef>
+#include <vector>
+
+// Headless replacement for BattleSystem's round loop.
+// Rules of the loop being reproduced: every round the attackers fire first, then
+// the surviving defenders. Each ship deals its attack power to the weakest enemy
+// (lowest health, ties to the ship that joined first). A ship killed mid-phase stays
+// targetable until the round ends, so the rest of that phase's fire lands on the
+// wreck. Each side therefore focuses one target per round. Dead ships are removed
+// when the round ends.
+//
+// Ships with identical stats are grouped into stacks, and runs of rounds in which
+// nobody dies are skipped in closed form. Cost scales with kills times stacks, not
+// rounds times ships. All arithmetic is integer, so the final health of every ship
+// matches the round loop exactly.
+class BattleResolver {
+public:
+    struct Combatant {
+        int health;
+        int attackPower;
+    };
+
+    struct Result {
+        long long rounds = 0;
+        // Final health per ship, in the order the ships were passed in; <= 0 means destroyed
+        std::vector<long long> attackerHealth;
+        std::vector<long long> defenderHealth;
+        // Neither side can damage the other, the round loop would never end
+        bool stalemate = false;
+    };
+
+    // Ships are listed in the order they joined the battle.
+    static Result resolve(const std::vector<Combatant>& attackers, const std::vector<Combatant>& defenders);
+
+private:
+    struct Stack {
+        int health;
+        int attackPower;
+        std::vector<int> members;
+        std::size_t next;
+    };
+
+    struct Side {
+        std::vector<Stack> stacks;
+        std::vector<long long>* health;
+        long long totalAttack = 0;
+        std::size_t alive = 0;
+        int target = -1;
+        int targetAttack = 0;
+    };
+
+    static void buildSide(const std::vector<Combatant>& ships, std::vector<long long>& health, Side& side);
+    static void pickTarget(Side& side);
+    static void removeTarget(Side& side);
+};
+
+#endif
@@ -0,0 +1,120 @@
+// entity_bitset.h
+#ifndef ENTITY_BITSET_H
+#define ENTITY_BITSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One bit per entity id (planet, ship, player, ...), packed 64 to a word.
+// Membership is O(1), and walking the set bits skips empty words whole.
+class EntityBitset {
+public:
+    // Bits added by growing take `value`; existing bits are kept.
+    void resize(std::size_t count, bool value = false) {
+        std::size_t oldCount = bitCount;
+        words.resize((count + 63) / 64, 0);
+        bitCount = count;
+        if (value) {
+            for (std::size_t i = oldCount; i < count; ++i) {
+                set(i);
+            }
+        }
+        clearTail();
+    }
+
+    std::size_t size() const { return bitCount; }
+
+    bool test(std::size_t index) const {
+        return index < bitCount && (words[index >> 6] >> (index & 63) & 1u) != 0;
+    }
+
+    void set(std::size_t index) { words[index >> 6] |= std::uint64_t(1) << (index & 63); }
+    void reset(std::size_t index) { words[index >> 6] &= ~(std::uint64_t(1) << (index & 63)); }
+
+    void assign(std::size_t index, bool value) {
+        if (value) {
+            set(index);
+        } else {
+            reset(index);
+        }
+    }
+
+    void setAll() {
+        for (std::uint64_t& word : words) {
+            word = ~std::uint64_t(0);
+        }
+        clearTail();
+    }
+
+    void clearAll() {
+        for (std::uint64_t& word : words) {
+            word = 0;
+        }
+    }
+
+    std::size_t count() const {
+        std::size_t total = 0;
+        for (std::uint64_t word : words) {
+            total += popCount(word);
+        }
+        return total;
+    }
+
+    // First set bit at or after `from`, or size() when there is none.
+    std::size_t findNext(std::size_t from) const {
+        if (from >= bitCount) {
+            return bitCount;
+        }
+        std::size_t wordIndex = from >> 6;
+        std::uint64_t word = words[wordIndex] & (~std::uint64_t(0) << (from & 63));
+        while (word == 0) {
+            if (++wordIndex == words.size()) {
+                return bitCount;
+            }
+            word = words[wordIndex];
+        }
+        return (wordIndex << 6) + lowestBit(word);
+    }
+
+    const std::vector<std::uint64_t>& getWords() const { return words; }
+
+private:
+    static std::size_t popCount(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(__builtin_popcountll(word));
+#else
+        std::size_t total = 0;
+        for (; word != 0; word &= word - 1) {
+            ++total;
+        }
+        return total;
+#endif
+    }
+
+    // word must be non-zero
+    static std::size_t lowestBit(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+        std::size_t bit = 0;
+        while ((word & 1u) == 0) {
+            word >>= 1;
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    // Keeps the bits past size() in the last word at zero, so count() and findNext() stay exact.
+    void clearTail() {
+        if ((bitCount & 63) != 0) {
+            words.back() &= (std::uint64_t(1) << (bitCount & 63)) - 1;
+        }
+    }
+
+    std::vector<std::uint64_t> words;
+    std::size_t bitCount = 0;
+};
+
+#endif
@@ -0,0 +1,54 @@
+// fixed_timestep.h
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+#include <cstdint>
+
+// Accumulator for a fixed-step simulation loop.
+// Each frame adds its wall-clock time and gets back how many steps of getStepSeconds()
+// to simulate, so results and per-step cost no longer depend on the frame rate. At most
+// maxStepsPerFrame steps are handed out per frame; time owed beyond that is dropped
+// (the game runs slower than real time) instead of being carried into ever longer
+// catch-up frames.
+//
+// getAlpha() is where the frame lies between the last two simulated states, in [0, 1),
+// for interpolating what is drawn.
+class FixedTimestep {
+public:
+    explicit FixedTimestep(double stepSeconds = 1.0 / 60.0, int maxStepsPerFrame = 8)
+        : stepSeconds(stepSeconds), maxStepsPerFrame(maxStepsPerFrame > 0 ? maxStepsPerFrame : 1) {}
+
+    int advance(double frameSeconds) {
+        if (frameSeconds > 0.0) {
+            accumulator += frameSeconds;
+        }
+        int steps = 0;
+        while (accumulator >= stepSeconds && steps < maxStepsPerFrame) {
+            accumulator -= stepSeconds;
+            ++steps;
+        }
+        if (accumulator >= stepSeconds) {
+            std::uint64_t owed = static_cast<std::uint64_t>(accumulator / stepSeconds);
+            droppedSteps += owed;
+            accumulator -= static_cast<double>(owed) * stepSeconds;
+        }
+        return steps;
+    }
+
+    // Forgets owed time, e.g. after a pause or a load, so the game does not fast-forward.
+    void reset() { accumulator = 0.0; }
+
+    double getStepSeconds() const { return stepSeconds; }
+    double getAlpha() const { return accumulator / stepSeconds; }
+    int getMaxStepsPerFrame() const { return maxStepsPerFrame; }
+    void setMaxStepsPerFrame(int steps) { maxStepsPerFrame = steps > 0 ? steps : 1; }
+    std::uint64_t getDroppedSteps() const { return droppedSteps; }
+
+private:
+    double stepSeconds;
+    int maxStepsPerFrame;
+    double accumulator = 0.0;
+    std::uint64_t droppedSteps = 0;
+};
+
+#endif
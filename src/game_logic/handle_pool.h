@@ -0,0 +1,180 @@
+// handle_pool.h
+#ifndef HANDLE_POOL_H
+#define HANDLE_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Generation-checked reference to an item in a HandlePool. When the item is
+// released its slot generation is bumped, so old handles resolve to nullptr
+// instead of to whatever reuses the slot.
+struct PoolHandle {
+    static constexpr std::uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    std::uint32_t index = kInvalidIndex;
+    std::uint32_t generation = 0;
+
+    bool isValid() const { return index != kInvalidIndex; }
+    bool operator==(const PoolHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const PoolHandle& other) const { return !(*this == other); }
+};
+
+// Maps handles to positions in a dense array owned by the caller.
+// The caller keeps its live items packed in [0, size()); on release it moves the
+// last item into the freed position, and releaseDense() patches the mapping to match.
+// Slots are recycled through a free list, so nothing allocates once the table has
+// reached its high-water mark.
+class HandleSlots {
+public:
+    void reserve(std::size_t capacity) {
+        denseToSlot.reserve(capacity);
+        slotToDense.reserve(capacity);
+        generations.reserve(capacity);
+        freeSlots.reserve(capacity);
+    }
+
+    void clear() {
+        // Bump every live generation so handles from before the clear go stale.
+        for (std::uint32_t slot : denseToSlot) {
+            ++generations[slot];
+            freeSlots.push_back(slot);
+        }
+        denseToSlot.clear();
+    }
+
+    std::size_t size() const { return denseToSlot.size(); }
+
+    // Maps a new handle to dense position size().
+    PoolHandle acquire() {
+        std::uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<std::uint32_t>(slotToDense.size());
+            slotToDense.push_back(0);
+            generations.push_back(0);
+        }
+        slotToDense[slot] = static_cast<std::uint32_t>(denseToSlot.size());
+        denseToSlot.push_back(slot);
+        return handleAt(denseToSlot.size() - 1);
+    }
+
+    // Frees dense position `dense`; the handle at the last position now maps to `dense`.
+    void releaseDense(std::size_t dense) {
+        std::uint32_t slot = denseToSlot[dense];
+        std::size_t last = denseToSlot.size() - 1;
+        if (dense != last) {
+            denseToSlot[dense] = denseToSlot[last];
+            slotToDense[denseToSlot[dense]] = static_cast<std::uint32_t>(dense);
+        }
+        denseToSlot.pop_back();
+        ++generations[slot];
+        freeSlots.push_back(slot);
+    }
+
+    bool isAlive(PoolHandle handle) const {
+        return handle.index < generations.size() && generations[handle.index] == handle.generation;
+    }
+
+    // Only meaningful for live handles.
+    std::size_t denseIndex(PoolHandle handle) const { return slotToDense[handle.index]; }
+
+    PoolHandle handleAt(std::size_t dense) const {
+        PoolHandle handle;
+        handle.index = denseToSlot[dense];
+        handle.generation = generations[handle.index];
+        return handle;
+    }
+
+private:
+    std::vector<std::uint32_t> denseToSlot;
+    std::vector<std::uint32_t> slotToDense;
+    std::vector<std::uint32_t> generations;
+    std::vector<std::uint32_t> freeSlots;
+};
+
+// Pool of T with live items packed in [0, size()).
+// Releasing an item swap-removes it from the dense array, so release is O(1) and
+// iteration never skips holes. After reserve(), or once the pool has hit its
+// high-water mark, acquire/release do no heap allocation. clear() keeps the
+// capacity for the next use.
+template <typename T>
+class HandlePool {
+public:
+    void reserve(std::size_t capacity) {
+        items.reserve(capacity);
+        slots.reserve(capacity);
+    }
+
+    void clear() {
+        items.clear();
+        slots.clear();
+    }
+
+    std::size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    std::size_t capacity() const { return items.capacity(); }
+
+    PoolHandle acquire(const T& value) {
+        items.push_back(value);
+        return slots.acquire();
+    }
+
+    bool release(PoolHandle handle) {
+        if (!slots.isAlive(handle)) {
+            return false;
+        }
+        releaseDense(slots.denseIndex(handle));
+        return true;
+    }
+
+    bool isAlive(PoolHandle handle) const { return slots.isAlive(handle); }
+
+    T* get(PoolHandle handle) {
+        return slots.isAlive(handle) ? &items[slots.denseIndex(handle)] : nullptr;
+    }
+
+    const T* get(PoolHandle handle) const {
+        return slots.isAlive(handle) ? &items[slots.denseIndex(handle)] : nullptr;
+    }
+
+    // Handle of the item currently stored at dense position i.
+    PoolHandle handleAt(std::size_t i) const { return slots.handleAt(i); }
+
+    // Calls update(item) on every live item and releases the ones it returns true for.
+    // The item swapped into a released position is visited in the same pass.
+    template <typename Function>
+    void updateAndCompact(Function update) {
+        std::size_t i = 0;
+        while (i < items.size()) {
+            if (update(items[i])) {
+                releaseDense(i);
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    T* begin() { return items.data(); }
+    T* end() { return items.data() + items.size(); }
+    const T* begin() const { return items.data(); }
+    const T* end() const { return items.data() + items.size(); }
+
+private:
+    void releaseDense(std::size_t dense) {
+        std::size_t last = items.size() - 1;
+        if (dense != last) {
+            items[dense] = std::move(items[last]);
+        }
+        items.pop_back();
+        slots.releaseDense(dense);
+    }
+
+    std::vector<T> items;
+    HandleSlots slots;
+};
+
+#endif
@@ -0,0 +1,194 @@
+// headless_match.cpp
+#include "headless_match.h"
+
+#include <algorithm>
+#include "battle_resolver.h"
+#include "../utility/profiler.h"
+
+namespace {
+
+enum MatchRandom : std::uint32_t {
+    MatchSetup = 1,
+    MatchAI = 2
+};
+
+// Population per ship when a planet's people are turned into a fleet or a garrison
+constexpr int kPopulationPerShip = 100;
+constexpr int kMaxPopulation = 10000;
+constexpr int kHomeworldPopulation = 1000;
+// How many of the nearest planets a fleet picks its target from
+constexpr std::size_t kTargetsConsidered = 4;
+
+} // namespace
+
+HeadlessMatch::HeadlessMatch(const Settings& matchSettings, std::uint64_t seed)
+    : settings(matchSettings), random(seed) {
+    settings.planets = std::max(1, settings.planets);
+    settings.players = std::min(std::max(1, settings.players), settings.planets);
+    settings.stepsPerTurn = std::max(1, settings.stepsPerTurn);
+    result.seed = seed;
+    result.planetsOwned.assign(settings.players, 0);
+    setUp();
+}
+
+void HeadlessMatch::setUp() {
+    RandomStream& setup = random.getStream(MatchSetup);
+    int mapSize = std::max(1, static_cast<int>(settings.mapSize));
+    planets.reserve(settings.planets);
+    for (int i = 0; i < settings.planets; ++i) {
+        int x = setup.nextInt(0, mapSize - 1);
+        int y = setup.nextInt(0, mapSize - 1);
+        int population = setup.nextInt(100, 600);
+        planets.addPlanet(x, y, -1, population, setup.nextDouble(-50.0, 50.0), setup.nextDouble(0.5, 2.0),
+                          setup.nextDouble(50.0, 150.0));
+    }
+
+    // Planets are placed at random, so spacing homeworlds by index spreads them as well as anything
+    for (int player = 0; player < settings.players; ++player) {
+        int homeworld = player * settings.planets / settings.players;
+        planets.playerOwner[homeworld] = player;
+        planets.population[homeworld] = kHomeworldPopulation;
+        planets.shipbuildingCapacity[homeworld] = 1;
+    }
+
+    for (int i = 0; i < settings.planets; ++i) {
+        planetGrid.insert(i, static_cast<float>(planets.x[i]), static_cast<float>(planets.y[i]), planets.playerOwner[i]);
+    }
+
+    playerRandom.clear();
+    for (int player = 0; player < settings.players; ++player) {
+        playerRandom.push_back(random.entityStream(MatchAI, static_cast<std::uint64_t>(player)));
+    }
+}
+
+bool HeadlessMatch::step() {
+    if (over) {
+        return false;
+    }
+    planets.update(settings.stepSeconds);
+    ++result.steps;
+    if (++stepInTurn == settings.stepsPerTurn) {
+        stepInTurn = 0;
+        playTurn();
+    }
+    return !over;
+}
+
+HeadlessMatch::Result HeadlessMatch::run() {
+    while (step()) {
+    }
+    return result;
+}
+
+void HeadlessMatch::playTurn() {
+    ProfileZone zone("HeadlessMatch::playTurn");
+    ++result.turns;
+    for (std::size_t i = 0; i < planets.size(); ++i) {
+        if (planets.playerOwner[i] >= 0) {
+            planets.population[i] = std::min(kMaxPopulation, planets.population[i] + planets.population[i] / 20);
+        }
+    }
+    for (int player = 0; player < settings.players; ++player) {
+        allocate(player);
+        attack(player);
+    }
+    checkOver();
+}
+
+void HeadlessMatch::allocate(int player) {
+    RandomStream& ai = playerRandom[player];
+    double allocation[PlanetStore::kResourceSlots];
+    for (std::size_t i = 0; i < planets.size(); ++i) {
+        if (planets.playerOwner[i] != player) {
+            continue;
+        }
+        ai.fillDoubles(allocation, PlanetStore::kResourceSlots, 0.01, 1.0);
+        double total = 0.0;
+        for (double share : allocation) {
+            total += share;
+        }
+        for (double& share : allocation) {
+            share /= total;
+        }
+        planets.allocateResources(static_cast<int>(i), allocation);
+    }
+}
+
+void HeadlessMatch::attack(int player) {
+    std::vector<int> sources;
+    for (std::size_t i = 0; i < planets.size(); ++i) {
+        if (planets.playerOwner[i] == player) {
+            sources.push_back(static_cast<int>(i));
+        }
+    }
+    std::vector<int> targets;
+    for (int source : sources) {
+        // The planet may have fallen to an earlier player this turn
+        if (planets.playerOwner[source] != player || planets.population[source] < 2 * kPopulationPerShip) {
+            continue;
+        }
+        targets.clear();
+        planetGrid.queryNearest(static_cast<float>(planets.x[source]), static_cast<float>(planets.y[source]),
+                                kTargetsConsidered, targets, SpatialGrid<int>::OtherOwner, player);
+        int fleet = planets.population[source] * 3 / 4 / kPopulationPerShip;
+        int target = -1;
+        for (int candidate : targets) {
+            if (fleet > garrisonOf(candidate) && (target < 0 || garrisonOf(candidate) < garrisonOf(target))) {
+                target = candidate;
+            }
+        }
+        if (target >= 0) {
+            fight(player, source, target, fleet);
+        }
+    }
+}
+
+int HeadlessMatch::garrisonOf(int planet) const {
+    return planets.population[planet] / (2 * kPopulationPerShip) + 2 * planets.defenseLevel[planet];
+}
+
+void HeadlessMatch::fight(int player, int source, int target, int fleet) {
+    planets.population[source] -= fleet * kPopulationPerShip;
+    std::vector<BattleResolver::Combatant> attackers(fleet, BattleResolver::Combatant{10, 4});
+    int militia = planets.population[target] / (2 * kPopulationPerShip);
+    std::vector<BattleResolver::Combatant> defenders(militia, BattleResolver::Combatant{10, 3});
+    defenders.insert(defenders.end(), planets.defenseLevel[target], BattleResolver::Combatant{20, 5});
+
+    BattleResolver::Result battle = BattleResolver::resolve(attackers, defenders);
+    ++result.battles;
+    auto alive = [](long long health) { return health > 0; };
+    int attackersLeft = static_cast<int>(std::count_if(battle.attackerHealth.begin(), battle.attackerHealth.end(), alive));
+    int militiaLost = militia - static_cast<int>(std::count_if(battle.defenderHealth.begin(),
+                                                                battle.defenderHealth.begin() + militia, alive));
+    bool defended = std::any_of(battle.defenderHealth.begin(), battle.defenderHealth.end(), alive);
+
+    planets.population[target] -= militiaLost * kPopulationPerShip;
+    if (!defended && attackersLeft > 0) {
+        planets.playerOwner[target] = player;
+        planets.population[target] += attackersLeft * kPopulationPerShip;
+        planetGrid.setOwner(target, player);
+    }
+}
+
+void HeadlessMatch::checkOver() {
+    std::fill(result.planetsOwned.begin(), result.planetsOwned.end(), 0);
+    for (int owner : planets.playerOwner) {
+        if (owner >= 0) {
+            ++result.planetsOwned[owner];
+        }
+    }
+    int playersLeft = 0;
+    int lastPlayer = -1;
+    for (int player = 0; player < settings.players; ++player) {
+        if (result.planetsOwned[player] > 0) {
+            ++playersLeft;
+            lastPlayer = player;
+        }
+    }
+    if (playersLeft <= 1) {
+        over = true;
+        result.winner = lastPlayer;
+    } else if (result.turns >= settings.maxTurns) {
+        over = true;
+    }
+}
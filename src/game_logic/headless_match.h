@@ -0,0 +1,70 @@
+// headless_match.h
+#ifndef HEADLESS_MATCH_H
+#define HEADLESS_MATCH_H
+
+#include <cstdint>
+#include <vector>
+#include "planet_store.h"
+#include "spatial_grid.h"
+#include "../utility/random_streams.h"
+
+// An AI-only game on the simulation core, with nothing to draw and no clock to wait on.
+// Planets run on the planet store every step. At each turn boundary every player,
+// in order, re-allocates its planets' resources, and each of its planets sends three
+// quarters of its people against the weakest of the nearest planets it does not own
+// whose garrison (half the population, plus defences) they outnumber. Fights go through
+// the battle resolver. The game ends when one player holds every owned planet, or after
+// maxTurns.
+// A match is a pure function of its settings and seed, so games can run in parallel
+// and any result can be reproduced.
+class HeadlessMatch {
+public:
+    struct Settings {
+        int players = 4;
+        int planets = 200;
+        float mapSize = 1000.0f;
+        double stepSeconds = 1.0 / 60.0;
+        int stepsPerTurn = 60;
+        int maxTurns = 500;
+    };
+
+    struct Result {
+        std::uint64_t seed = 0;
+        // -1 when the turn limit was reached first
+        int winner = -1;
+        int turns = 0;
+        std::uint64_t steps = 0;
+        int battles = 0;
+        std::vector<int> planetsOwned;
+    };
+
+    HeadlessMatch(const Settings& settings, std::uint64_t seed);
+
+    // One simulation step, ending the turn when it is due. False once the game is over.
+    bool step();
+    Result run();
+
+    bool isOver() const { return over; }
+    const Result& getResult() const { return result; }
+    const PlanetStore& getPlanets() const { return planets; }
+
+private:
+    void setUp();
+    void playTurn();
+    void allocate(int player);
+    void attack(int player);
+    int garrisonOf(int planet) const;
+    void fight(int player, int source, int target, int fleet);
+    void checkOver();
+
+    Settings settings;
+    RandomService random;
+    std::vector<RandomStream> playerRandom;
+    PlanetStore planets;
+    SpatialGrid<int> planetGrid{128.0f};
+    Result result;
+    int stepInTurn = 0;
+    bool over = false;
+};
+
+#endif
@@ -0,0 +1,177 @@
+// minimap_grid.cpp
+#include "minimap_grid.h"
+
+#include <algorithm>
+
+MinimapGrid::MinimapGrid(float worldWidth, float worldHeight, int columns, int rows) {
+    reset(worldWidth, worldHeight, columns, rows);
+}
+
+void MinimapGrid::reset(float width, float height, int columnCount, int rowCount) {
+    worldWidth = width > 0.0f ? width : 1.0f;
+    worldHeight = height > 0.0f ? height : 1.0f;
+    columns = std::max(1, columnCount);
+    rows = std::max(1, rowCount);
+    std::size_t cellCount = static_cast<std::size_t>(columns) * static_cast<std::size_t>(rows);
+
+    planets.clear();
+    ships.clear();
+    planetOwners.assign(cellCount, {});
+    shipOwners.assign(cellCount, {});
+    cells.assign(cellCount, Cell{kEmpty, kEmpty});
+    dirtyFlags.assign(cellCount, 0);
+    dirtyCells.clear();
+    ++revision;
+}
+
+int MinimapGrid::cellAt(float x, float y) const {
+    int column = static_cast<int>(x / worldWidth * static_cast<float>(columns));
+    int row = static_cast<int>(y / worldHeight * static_cast<float>(rows));
+    column = std::min(std::max(column, 0), columns - 1);
+    row = std::min(std::max(row, 0), rows - 1);
+    return row * columns + column;
+}
+
+void MinimapGrid::add(CellOwners& owners, int cell, int owner) {
+    std::vector<OwnerCount>& counts = owners[cell];
+    for (OwnerCount& entry : counts) {
+        if (entry.owner == owner) {
+            ++entry.count;
+            return;
+        }
+    }
+    counts.push_back({owner, 1});
+    markDirty(cell);
+}
+
+void MinimapGrid::remove(CellOwners& owners, int cell, int owner) {
+    std::vector<OwnerCount>& counts = owners[cell];
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i].owner == owner) {
+            if (--counts[i].count == 0) {
+                counts[i] = counts.back();
+                counts.pop_back();
+                markDirty(cell);
+            }
+            return;
+        }
+    }
+}
+
+void MinimapGrid::markDirty(int cell) {
+    if (!dirtyFlags[cell]) {
+        dirtyFlags[cell] = 1;
+        dirtyCells.push_back(cell);
+    }
+}
+
+std::int32_t MinimapGrid::summarize(const std::vector<OwnerCount>& owners) {
+    if (owners.empty()) {
+        return kEmpty;
+    }
+    return owners.size() == 1 ? owners.front().owner : kContested;
+}
+
+void MinimapGrid::addPlanet(int planetId, float x, float y, int owner) {
+    if (planetId < 0) {
+        return;
+    }
+    if (static_cast<std::size_t>(planetId) >= planets.size()) {
+        planets.resize(planetId + 1, Entity{-1, kUnowned});
+    }
+    Entity& planet = planets[planetId];
+    if (planet.cell >= 0) {
+        remove(planetOwners, planet.cell, planet.owner);
+    }
+    planet.cell = cellAt(x, y);
+    planet.owner = owner;
+    add(planetOwners, planet.cell, owner);
+}
+
+void MinimapGrid::setPlanetOwner(int planetId, int owner) {
+    if (planetId < 0 || static_cast<std::size_t>(planetId) >= planets.size() || planets[planetId].cell < 0) {
+        return;
+    }
+    Entity& planet = planets[planetId];
+    if (planet.owner != owner) {
+        remove(planetOwners, planet.cell, planet.owner);
+        planet.owner = owner;
+        add(planetOwners, planet.cell, owner);
+    }
+}
+
+void MinimapGrid::clearPlanets() {
+    for (const Entity& planet : planets) {
+        if (planet.cell >= 0) {
+            remove(planetOwners, planet.cell, planet.owner);
+        }
+    }
+    planets.clear();
+}
+
+void MinimapGrid::addShip(int shipId, float x, float y, int owner) {
+    if (shipId < 0) {
+        return;
+    }
+    if (static_cast<std::size_t>(shipId) >= ships.size()) {
+        ships.resize(shipId + 1, Entity{-1, kUnowned});
+    }
+    Entity& ship = ships[shipId];
+    if (ship.cell >= 0) {
+        remove(shipOwners, ship.cell, ship.owner);
+    }
+    ship.cell = cellAt(x, y);
+    ship.owner = owner;
+    add(shipOwners, ship.cell, owner);
+}
+
+void MinimapGrid::moveShip(int shipId, float x, float y) {
+    if (shipId < 0 || static_cast<std::size_t>(shipId) >= ships.size() || ships[shipId].cell < 0) {
+        return;
+    }
+    Entity& ship = ships[shipId];
+    int cell = cellAt(x, y);
+    if (cell != ship.cell) {
+        remove(shipOwners, ship.cell, ship.owner);
+        ship.cell = cell;
+        add(shipOwners, cell, ship.owner);
+    }
+}
+
+void MinimapGrid::setShipOwner(int shipId, int owner) {
+    if (shipId < 0 || static_cast<std::size_t>(shipId) >= ships.size() || ships[shipId].cell < 0) {
+        return;
+    }
+    Entity& ship = ships[shipId];
+    if (ship.owner != owner) {
+        remove(shipOwners, ship.cell, ship.owner);
+        ship.owner = owner;
+        add(shipOwners, ship.cell, owner);
+    }
+}
+
+void MinimapGrid::clearShips() {
+    for (const Entity& ship : ships) {
+        if (ship.cell >= 0) {
+            remove(shipOwners, ship.cell, ship.owner);
+        }
+    }
+    ships.clear();
+}
+
+std::size_t MinimapGrid::update() {
+    std::size_t changed = 0;
+    for (int cell : dirtyCells) {
+        dirtyFlags[cell] = 0;
+        Cell summary{summarize(planetOwners[cell]), summarize(shipOwners[cell])};
+        if (summary != cells[cell]) {
+            cells[cell] = summary;
+            ++changed;
+        }
+    }
+    dirtyCells.clear();
+    if (changed > 0) {
+        ++revision;
+    }
+    return changed;
+}
@@ -0,0 +1,92 @@
+// minimap_grid.h
+#ifndef MINIMAP_GRID_H
+#define MINIMAP_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// What the minimap shows, reduced to a coarse grid over the map: for each cell, who owns
+// the planets in it and whose ships are in it.
+// It takes the same change events as the visibility system. A cell is only recomputed
+// when a planet or ship enters it, leaves it or changes hands inside it, so a ship
+// moving within its cell costs one comparison, and the revision only moves when a cell
+// looks different. Positions outside the mapped area count towards the edge cells.
+class MinimapGrid {
+public:
+    // Cell owners besides player numbers
+    static constexpr std::int32_t kUnowned = -1;    // the galaxy's "no owner"
+    static constexpr std::int32_t kEmpty = -2;      // nothing of that kind in the cell
+    static constexpr std::int32_t kContested = -3;  // more than one owner
+
+    struct Cell {
+        std::int32_t planetOwner;
+        std::int32_t shipOwner;
+
+        bool operator==(const Cell& other) const {
+            return planetOwner == other.planetOwner && shipOwner == other.shipOwner;
+        }
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+
+    explicit MinimapGrid(float worldWidth = 1000.0f, float worldHeight = 1000.0f, int columns = 64, int rows = 64);
+
+    // Forgets every planet and ship.
+    void reset(float worldWidth, float worldHeight, int columns, int rows);
+
+    // Planet ids are dense and match the galaxy's planet ids.
+    void addPlanet(int planetId, float x, float y, int owner);
+    void setPlanetOwner(int planetId, int owner);
+    void clearPlanets();
+
+    // Ship ids are dense, in the order the ships were added.
+    void addShip(int shipId, float x, float y, int owner);
+    void moveShip(int shipId, float x, float y);
+    void setShipOwner(int shipId, int owner);
+    void clearShips();
+
+    // Recomputes the cells changed since the last call. Returns how many now look different.
+    std::size_t update();
+
+    // Moves whenever update() changes how a cell looks.
+    std::uint64_t getRevision() const { return revision; }
+
+    int getColumns() const { return columns; }
+    int getRows() const { return rows; }
+    const std::vector<Cell>& getCells() const { return cells; }
+
+private:
+    struct Entity {
+        std::int32_t cell;
+        std::int32_t owner;
+    };
+
+    struct OwnerCount {
+        std::int32_t owner;
+        std::uint32_t count;
+    };
+
+    // Per cell, how many planets or ships each owner has there; rarely more than one entry
+    using CellOwners = std::vector<std::vector<OwnerCount>>;
+
+    int cellAt(float x, float y) const;
+    void add(CellOwners& owners, int cell, int owner);
+    void remove(CellOwners& owners, int cell, int owner);
+    void markDirty(int cell);
+    static std::int32_t summarize(const std::vector<OwnerCount>& owners);
+
+    float worldWidth;
+    float worldHeight;
+    int columns;
+    int rows;
+    std::vector<Entity> planets;
+    std::vector<Entity> ships;
+    CellOwners planetOwners;
+    CellOwners shipOwners;
+    std::vector<Cell> cells;
+    std::vector<std::uint8_t> dirtyFlags;
+    std::vector<int> dirtyCells;
+    std::uint64_t revision = 0;
+};
+
+#endif
@@ -0,0 +1,76 @@
+// observation_view.h
+#ifndef OBSERVATION_VIEW_H
+#define OBSERVATION_VIEW_H
+
+#include <algorithm>
+#include <cstddef>
+#include "entity_bitset.h"
+
+// Read-only, filtered window onto a galaxy container: it visits source[i] only
+// where bit i of the visibility set is on. Nothing is copied, so rebuilding a view
+// each AI update costs two pointer writes.
+// Source needs size() and a const operator[]; elements come back as whatever that
+// operator returns (a const reference, or a planet handle).
+// The view must not outlive the source or the bitset.
+template <typename Source>
+class ObservationView {
+public:
+    class iterator {
+    public:
+        iterator(const Source* source, const EntityBitset* visible, std::size_t index, std::size_t limit)
+            : source(source), visible(visible), position(index), limit(limit) {}
+
+        decltype(auto) operator*() const { return (*source)[position]; }
+
+        // Entity id of the current element
+        std::size_t index() const { return position; }
+
+        iterator& operator++() {
+            position = std::min(visible->findNext(position + 1), limit);
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const { return position == other.position; }
+        bool operator!=(const iterator& other) const { return position != other.position; }
+
+    private:
+        const Source* source;
+        const EntityBitset* visible;
+        std::size_t position;
+        std::size_t limit;
+    };
+
+    ObservationView() = default;
+    ObservationView(const Source& source, const EntityBitset& visible) : source(&source), visible(&visible) {}
+
+    iterator begin() const {
+        std::size_t end = limit();
+        return iterator(source, visible, end == 0 ? 0 : std::min(visible->findNext(0), end), end);
+    }
+
+    iterator end() const { return iterator(source, visible, limit(), limit()); }
+
+    bool contains(std::size_t index) const { return index < limit() && visible->test(index); }
+    bool empty() const { return begin() == end(); }
+
+    std::size_t size() const {
+        if (source != nullptr && limit() == visible->size()) {
+            return visible->count();
+        }
+        std::size_t total = 0;
+        for (iterator it = begin(); it != end(); ++it) {
+            ++total;
+        }
+        return total;
+    }
+
+private:
+    std::size_t limit() const {
+        return source == nullptr ? 0 : std::min<std::size_t>(source->size(), visible->size());
+    }
+
+    const Source* source = nullptr;
+    const EntityBitset* visible = nullptr;
+};
+
+#endif
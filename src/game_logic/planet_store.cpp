@@ -0,0 +1,229 @@
+// planet_store.cpp
+#include "planet_store.h"
+
+int PlanetStore::addPlanet(int x, int y, int playerOwner, int population, double temperature, double gravity, double metal) {
+    int index = static_cast<int>(size());
+
+    this->x.push_back(x);
+    this->y.push_back(y);
+    this->playerOwner.push_back(playerOwner);
+    this->population.push_back(population);
+    this->temperature.push_back(temperature);
+    this->gravity.push_back(gravity);
+    this->metal.push_back(metal);
+    energy.push_back(0.0);
+    food.push_back(0.0);
+    infrastructure.push_back(0.0);
+    defense.push_back(0.0);
+
+    incomeGenerated.insert(incomeGenerated.end(), kResourceSlots, 0.0);
+    devotedResources.insert(devotedResources.end(), kResourceSlots, 0.0);
+
+    terraformingLevel.push_back(0);
+    miningLevel.push_back(0);
+    shipbuildingCapacity.push_back(0);
+    defenseLevel.push_back(0);
+    isVolcanicPlanet.push_back(0);
+    isRadioactivePlanet.push_back(0);
+    isFertilePlanet.push_back(0);
+    orbitalShips.emplace_back();
+    shipsInProduction.emplace_back();
+
+    return index;
+}
+
+void PlanetStore::reserve(std::size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    playerOwner.reserve(count);
+    population.reserve(count);
+    temperature.reserve(count);
+    gravity.reserve(count);
+    metal.reserve(count);
+    energy.reserve(count);
+    food.reserve(count);
+    infrastructure.reserve(count);
+    defense.reserve(count);
+    incomeGenerated.reserve(count * kResourceSlots);
+    devotedResources.reserve(count * kResourceSlots);
+    terraformingLevel.reserve(count);
+    miningLevel.reserve(count);
+    shipbuildingCapacity.reserve(count);
+    defenseLevel.reserve(count);
+    isVolcanicPlanet.reserve(count);
+    isRadioactivePlanet.reserve(count);
+    isFertilePlanet.reserve(count);
+    orbitalShips.reserve(count);
+    shipsInProduction.reserve(count);
+}
+
+void PlanetStore::clear() {
+    x.clear();
+    y.clear();
+    playerOwner.clear();
+    population.clear();
+    temperature.clear();
+    gravity.clear();
+    metal.clear();
+    energy.clear();
+    food.clear();
+    infrastructure.clear();
+    defense.clear();
+    incomeGenerated.clear();
+    devotedResources.clear();
+    terraformingLevel.clear();
+    miningLevel.clear();
+    shipbuildingCapacity.clear();
+    defenseLevel.clear();
+    isVolcanicPlanet.clear();
+    isRadioactivePlanet.clear();
+    isFertilePlanet.clear();
+    orbitalShips.clear();
+    shipsInProduction.clear();
+}
+
+void PlanetStore::resize(std::size_t count) {
+    x.resize(count);
+    y.resize(count);
+    playerOwner.resize(count);
+    population.resize(count);
+    temperature.resize(count);
+    gravity.resize(count);
+    metal.resize(count);
+    energy.resize(count);
+    food.resize(count);
+    infrastructure.resize(count);
+    defense.resize(count);
+    incomeGenerated.resize(count * kResourceSlots);
+    devotedResources.resize(count * kResourceSlots);
+    terraformingLevel.resize(count);
+    miningLevel.resize(count);
+    shipbuildingCapacity.resize(count);
+    defenseLevel.resize(count);
+    isVolcanicPlanet.resize(count);
+    isRadioactivePlanet.resize(count);
+    isFertilePlanet.resize(count);
+    orbitalShips.resize(count);
+    shipsInProduction.resize(count);
+}
+
+std::size_t PlanetStore::size() const {
+    return population.size();
+}
+
+void PlanetStore::update(double deltaTime) {
+    updateRange(deltaTime, 0, size());
+}
+
+void PlanetStore::updateRange(double deltaTime, std::size_t begin, std::size_t end) {
+    updatePopulationGrowth(deltaTime, begin, end);
+    updateResourceProduction(deltaTime, begin, end);
+    updateInfrastructure(deltaTime, begin, end);
+    updateDefense(deltaTime, begin, end);
+    applySpecialEffects(deltaTime, begin, end);
+    updateIncome(begin, end);
+}
+
+void PlanetStore::updatePopulationGrowth(double deltaTime, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        double growthRate = calculateGrowthRate(i);
+        double carryingCapacity = calculateCarryingCapacity(i);
+        if (carryingCapacity <= 0.0) {
+            continue;
+        }
+        population[i] += static_cast<int>(population[i] * growthRate * (1 - population[i] / carryingCapacity) * deltaTime);
+    }
+}
+
+void PlanetStore::updateResourceProduction(double deltaTime, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        metal[i] += calculateMetalProduction(i) * deltaTime;
+    }
+    for (std::size_t i = begin; i < end; ++i) {
+        energy[i] += calculateEnergyProduction(i) * deltaTime;
+    }
+    for (std::size_t i = begin; i < end; ++i) {
+        food[i] += calculateFoodProduction(i) * deltaTime;
+    }
+}
+
+void PlanetStore::updateInfrastructure(double deltaTime, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        infrastructure[i] += calculateInfrastructureGrowth(i) * deltaTime;
+    }
+}
+
+void PlanetStore::updateDefense(double deltaTime, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        defense[i] += calculateDefenseGrowth(i) * deltaTime;
+    }
+}
+
+void PlanetStore::applySpecialEffects(double deltaTime, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        if (isVolcanicPlanet[i]) {
+            increaseMetalProduction(i, deltaTime);
+            applyVolcanicActivityEffects(i, deltaTime);
+        }
+        if (isRadioactivePlanet[i]) {
+            increaseEnergyProduction(i, deltaTime);
+            applyRadioactiveEffects(i, deltaTime);
+        }
+        if (isFertilePlanet[i]) {
+            increaseFoodProduction(i, deltaTime);
+            applyFertileSoilEffects(i, deltaTime);
+        }
+    }
+}
+
+void PlanetStore::updateIncome(std::size_t begin, std::size_t end) {
+    const double incomeFactor = 0.1;
+    for (std::size_t i = begin; i < end; ++i) {
+        const double scaledPopulation = population[i] * incomeFactor;
+        double* income = &incomeGenerated[i * kResourceSlots];
+        const double* devoted = &devotedResources[i * kResourceSlots];
+        for (int slot = 0; slot < kResourceSlots; ++slot) {
+            income[slot] = scaledPopulation * devoted[slot];
+        }
+    }
+}
+
+void PlanetStore::allocateResources(int index, const double* allocation) {
+    double* devoted = devotedRow(index);
+    for (int slot = 0; slot < kResourceSlots; ++slot) {
+        devoted[slot] = allocation[slot] * metal[index];
+    }
+}
+
+void PlanetStore::buildShip(int index, int shipType) {
+    if (metal[index] >= 100 && shipbuildingCapacity[index] > 0) {
+        shipsInProduction[index].push_back(shipType);
+        metal[index] -= 100;
+        --shipbuildingCapacity[index];
+    }
+}
+
+double PlanetStore::getIncome(int index) const {
+    const double* income = incomeRow(index);
+    double total = 0.0;
+    for (int slot = 0; slot < kResourceSlots; ++slot) {
+        total += income[slot];
+    }
+    return total;
+}
+
+double* PlanetStore::incomeRow(int index) {
+    return &incomeGenerated[static_cast<std::size_t>(index) * kResourceSlots];
+}
+
+const double* PlanetStore::incomeRow(int index) const {
+    return &incomeGenerated[static_cast<std::size_t>(index) * kResourceSlots];
+}
+
+double* PlanetStore::devotedRow(int index) {
+    return &devotedResources[static_cast<std::size_t>(index) * kResourceSlots];
+}
+
+const double* PlanetStore::devotedRow(int index) const {
+    return &devotedResources[static_cast<std::size_t>(index) * kResourceSlots];
+}
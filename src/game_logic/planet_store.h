@@ -0,0 +1,93 @@
+// planet_store.h
+#ifndef PLANET_STORE_H
+#define PLANET_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../utility/small_vector.h"
+
+// Columnar storage for every planet in the galaxy.
+// Each planet field lives in its own contiguous column, indexed by planet id,
+// so the per-tick passes in update() are linear sweeps over flat arrays.
+// The Planet struct is only a handle (store pointer + index) into these columns.
+class PlanetStore {
+public:
+    static constexpr int kResourceSlots = 5;
+    // Ships a planet holds without allocating; busier planets spill to the heap
+    static constexpr std::size_t kInlineShips = 4;
+    using ShipList = SmallVector<int, kInlineShips>;
+
+    int addPlanet(int x, int y, int playerOwner, int population, double temperature, double gravity, double metal);
+    void reserve(std::size_t count);
+    void clear();
+    // Grows or shrinks every column to count rows; new rows are zeroed, like addPlanet(0, 0, 0, 0, 0, 0, 0).
+    void resize(std::size_t count);
+    std::size_t size() const;
+
+    // Every pass only touches rows in [begin, end), so disjoint ranges can be
+    // swept on different threads without changing the result.
+    void update(double deltaTime);
+    void updateRange(double deltaTime, std::size_t begin, std::size_t end);
+    void updatePopulationGrowth(double deltaTime, std::size_t begin, std::size_t end);
+    void updateResourceProduction(double deltaTime, std::size_t begin, std::size_t end);
+    void updateInfrastructure(double deltaTime, std::size_t begin, std::size_t end);
+    void updateDefense(double deltaTime, std::size_t begin, std::size_t end);
+    void applySpecialEffects(double deltaTime, std::size_t begin, std::size_t end);
+    void updateIncome(std::size_t begin, std::size_t end);
+
+    void allocateResources(int index, const double* allocation);
+    void buildShip(int index, int shipType);
+    double getIncome(int index) const;
+
+    double* incomeRow(int index);
+    const double* incomeRow(int index) const;
+    double* devotedRow(int index);
+    const double* devotedRow(int index) const;
+
+    // Hot columns, touched every tick
+    std::vector<int> x;
+    std::vector<int> y;
+    std::vector<int> playerOwner;
+    std::vector<int> population;
+    std::vector<double> temperature;
+    std::vector<double> gravity;
+    std::vector<double> metal;
+    std::vector<double> energy;
+    std::vector<double> food;
+    std::vector<double> infrastructure;
+    std::vector<double> defense;
+
+    // kResourceSlots entries per planet, planet i occupies [i * kResourceSlots, (i + 1) * kResourceSlots)
+    std::vector<double> incomeGenerated;
+    std::vector<double> devotedResources;
+
+    // Cold columns, only touched by player actions
+    std::vector<int> terraformingLevel;
+    std::vector<int> miningLevel;
+    std::vector<int> shipbuildingCapacity;
+    std::vector<int> defenseLevel;
+    std::vector<std::uint8_t> isVolcanicPlanet;
+    std::vector<std::uint8_t> isRadioactivePlanet;
+    std::vector<std::uint8_t> isFertilePlanet;
+    std::vector<ShipList> orbitalShips;
+    std::vector<ShipList> shipsInProduction;
+
+private:
+    // Placeholder functions for calculations and effects
+    double calculateGrowthRate(std::size_t) const { return 0.0; }
+    double calculateCarryingCapacity(std::size_t) const { return 0.0; }
+    double calculateMetalProduction(std::size_t) const { return 0.0; }
+    double calculateEnergyProduction(std::size_t) const { return 0.0; }
+    double calculateFoodProduction(std::size_t) const { return 0.0; }
+    double calculateInfrastructureGrowth(std::size_t) const { return 0.0; }
+    double calculateDefenseGrowth(std::size_t) const { return 0.0; }
+    void increaseMetalProduction(std::size_t, double) {}
+    void applyVolcanicActivityEffects(std::size_t, double) {}
+    void increaseEnergyProduction(std::size_t, double) {}
+    void applyRadioactiveEffects(std::size_t, double) {}
+    void increaseFoodProduction(std::size_t, double) {}
+    void applyFertileSoilEffects(std::size_t, double) {}
+};
+
+#endif
@@ -0,0 +1,186 @@
+// projectile_store.cpp
+#include "projectile_store.h"
+
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PROJECTILE_STORE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+bool cpuHasAvx2() {
+#ifdef PROJECTILE_STORE_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+}
+
+PoolHandle ProjectileStore::spawn(float x, float y, float speed, double damage, PoolHandle target, PoolHandle source) {
+    this->x.push_back(x);
+    this->y.push_back(y);
+    velocityX.push_back(0.0f);
+    velocityY.push_back(0.0f);
+    this->speed.push_back(speed);
+    targetX.push_back(x);
+    targetY.push_back(y);
+    this->damage.push_back(damage);
+    this->target.push_back(target);
+    this->source.push_back(source);
+    hit.push_back(0);
+    return slots.acquire();
+}
+
+bool ProjectileStore::release(PoolHandle handle) {
+    if (!slots.isAlive(handle)) {
+        return false;
+    }
+    releaseAt(slots.denseIndex(handle));
+    return true;
+}
+
+void ProjectileStore::releaseAt(std::size_t index) {
+    std::size_t last = size() - 1;
+    if (index != last) {
+        x[index] = x[last];
+        y[index] = y[last];
+        velocityX[index] = velocityX[last];
+        velocityY[index] = velocityY[last];
+        speed[index] = speed[last];
+        targetX[index] = targetX[last];
+        targetY[index] = targetY[last];
+        damage[index] = damage[last];
+        target[index] = target[last];
+        source[index] = source[last];
+        hit[index] = hit[last];
+    }
+    x.pop_back();
+    y.pop_back();
+    velocityX.pop_back();
+    velocityY.pop_back();
+    speed.pop_back();
+    targetX.pop_back();
+    targetY.pop_back();
+    damage.pop_back();
+    target.pop_back();
+    source.pop_back();
+    hit.pop_back();
+    slots.releaseDense(index);
+}
+
+bool ProjectileStore::isAlive(PoolHandle handle) const {
+    return slots.isAlive(handle);
+}
+
+void ProjectileStore::reserve(std::size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    velocityX.reserve(count);
+    velocityY.reserve(count);
+    speed.reserve(count);
+    targetX.reserve(count);
+    targetY.reserve(count);
+    damage.reserve(count);
+    target.reserve(count);
+    source.reserve(count);
+    hit.reserve(count);
+    slots.reserve(count);
+}
+
+void ProjectileStore::clear() {
+    x.clear();
+    y.clear();
+    velocityX.clear();
+    velocityY.clear();
+    speed.clear();
+    targetX.clear();
+    targetY.clear();
+    damage.clear();
+    target.clear();
+    source.clear();
+    hit.clear();
+    slots.clear();
+}
+
+std::size_t ProjectileStore::size() const {
+    return x.size();
+}
+
+void ProjectileStore::integrate(float deltaTime) {
+    std::size_t done = cpuHasAvx2() ? integrateAvx2(deltaTime) : 0;
+    integrateScalar(deltaTime, done, size());
+}
+
+// Both paths perform the same float operations in the same order:
+// velocity = direction / distance * speed, position += velocity * deltaTime.
+void ProjectileStore::integrateScalar(float deltaTime, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        float dx = targetX[i] - x[i];
+        float dy = targetY[i] - y[i];
+        float distance = std::sqrt(dx * dx + dy * dy);
+        float vx = 0.0f;
+        float vy = 0.0f;
+        if (distance > 0.0f) {
+            vx = dx / distance * speed[i];
+            vy = dy / distance * speed[i];
+        }
+        velocityX[i] = vx;
+        velocityY[i] = vy;
+        x[i] += vx * deltaTime;
+        y[i] += vy * deltaTime;
+        hit[i] = distance <= speed[i] * deltaTime ? 1 : 0;
+    }
+}
+
+#ifdef PROJECTILE_STORE_AVX2
+
+__attribute__((target("avx2")))
+static std::size_t integrateAvx2Kernel(float deltaTime, std::size_t count, float* x, float* y,
+                                       float* velocityX, float* velocityY, const float* speed,
+                                       const float* targetX, const float* targetY, std::uint8_t* hit) {
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 zero = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 px = _mm256_loadu_ps(x + i);
+        __m256 py = _mm256_loadu_ps(y + i);
+        __m256 s = _mm256_loadu_ps(speed + i);
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(targetX + i), px);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(targetY + i), py);
+        __m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+
+        // Lanes that are already on top of their target do not move.
+        __m256 moving = _mm256_cmp_ps(distance, zero, _CMP_GT_OQ);
+        __m256 vx = _mm256_and_ps(moving, _mm256_mul_ps(_mm256_div_ps(dx, distance), s));
+        __m256 vy = _mm256_and_ps(moving, _mm256_mul_ps(_mm256_div_ps(dy, distance), s));
+
+        _mm256_storeu_ps(velocityX + i, vx);
+        _mm256_storeu_ps(velocityY + i, vy);
+        _mm256_storeu_ps(x + i, _mm256_add_ps(px, _mm256_mul_ps(vx, dt)));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(py, _mm256_mul_ps(vy, dt)));
+
+        int hits = _mm256_movemask_ps(_mm256_cmp_ps(distance, _mm256_mul_ps(s, dt), _CMP_LE_OQ));
+        for (int lane = 0; lane < 8; ++lane) {
+            hit[i + lane] = static_cast<std::uint8_t>((hits >> lane) & 1);
+        }
+    }
+    return i;
+}
+
+std::size_t ProjectileStore::integrateAvx2(float deltaTime) {
+    return integrateAvx2Kernel(deltaTime, size(), x.data(), y.data(), velocityX.data(), velocityY.data(),
+                               speed.data(), targetX.data(), targetY.data(), hit.data());
+}
+
+#else
+
+std::size_t ProjectileStore::integrateAvx2(float) {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,53 @@
+// projectile_store.h
+#ifndef PROJECTILE_STORE_H
+#define PROJECTILE_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "handle_pool.h"
+
+// Columnar storage for the live projectiles of one battle.
+// Live projectiles are packed in [0, size()) and every field is its own column, so
+// integrate() can move the whole battle in one vectorised sweep. Released projectiles
+// are swap-removed across all columns; handles stay valid through HandleSlots.
+//
+// A tick is three passes, driven by the owner:
+//   1. write each projectile's target position into targetX/targetY,
+//   2. integrate() moves everything and sets the hit column (touches no ships),
+//   3. apply damage for every hit and release it.
+class ProjectileStore {
+public:
+    PoolHandle spawn(float x, float y, float speed, double damage, PoolHandle target, PoolHandle source);
+    bool release(PoolHandle handle);
+    void releaseAt(std::size_t index);
+    bool isAlive(PoolHandle handle) const;
+    void reserve(std::size_t count);
+    void clear();
+    std::size_t size() const;
+
+    // Steps every projectile towards its target and sets hit[i] when it arrives
+    // this tick. Uses AVX2 when the CPU supports it; the scalar path gives
+    // bit-identical results.
+    void integrate(float deltaTime);
+    void integrateScalar(float deltaTime, std::size_t begin, std::size_t end);
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+    std::vector<float> speed;
+    std::vector<float> targetX;
+    std::vector<float> targetY;
+    std::vector<double> damage;
+    std::vector<PoolHandle> target;
+    std::vector<PoolHandle> source;
+    std::vector<std::uint8_t> hit;
+
+private:
+    std::size_t integrateAvx2(float deltaTime);
+
+    HandleSlots slots;
+};
+
+#endif
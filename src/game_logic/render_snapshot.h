@@ -0,0 +1,69 @@
+// render_snapshot.h
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "minimap_grid.h"
+
+// Everything the render thread draws for one simulation step, copied out of the game
+// state so drawing never reads anything the simulation is writing. Only what the
+// screen needs: positions, colours, radii and text.
+struct RenderSnapshot {
+    using Clock = std::chrono::steady_clock;
+
+    struct Shape {
+        float x;
+        float y;
+        // Position before the step, so motion can be drawn between steps
+        float previousX;
+        float previousY;
+        float radius;
+        float rotation;         // degrees
+        std::uint32_t color;    // RGBA, as sf::Color::toInteger()
+    };
+
+    struct Label {
+        float x;
+        float y;
+        std::uint32_t color;
+        std::string text;
+    };
+
+    std::vector<Shape> stars;
+    std::vector<Shape> planets;
+    std::vector<Shape> ships;
+    std::vector<Label> labels;
+    // Copied only when the minimap's revision moves; clear() leaves it alone
+    std::vector<MinimapGrid::Cell> minimapCells;
+    int minimapColumns = 0;
+    int minimapRows = 0;
+    std::uint64_t minimapRevision = 0;
+    std::uint64_t step = 0;
+    double stepSeconds = 0.0;
+    Clock::time_point publishedAt;
+
+    // Keeps the vectors' capacity, so refilling a reused snapshot does not allocate.
+    void clear() {
+        stars.clear();
+        planets.clear();
+        ships.clear();
+        labels.clear();
+    }
+
+    // How far from the previous to the current positions to draw at `now`, in [0, 1].
+    // The next step is due stepSeconds after publishing, and by then a newer snapshot
+    // should have replaced this one.
+    float interpolationAt(Clock::time_point now) const {
+        if (stepSeconds <= 0.0) {
+            return 1.0f;
+        }
+        double elapsed = std::chrono::duration<double>(now - publishedAt).count();
+        return static_cast<float>(std::min(1.0, std::max(0.0, elapsed / stepSeconds)));
+    }
+};
+
+#endif
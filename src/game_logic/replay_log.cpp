@@ -0,0 +1,141 @@
+// replay_log.cpp
+#include "replay_log.h"
+
+#include <algorithm>
+#include <limits>
+#include "../utility/async_file_writer.h"
+#include "../utility/binary_archive.h"
+
+void ReplayLog::clear() {
+    seed = 0;
+    tickCount = 0;
+    tickRuns.clear();
+    commands.clear();
+}
+
+void ReplayLog::addTick(double seconds) {
+    if (tickRuns.empty() || tickRuns.back().seconds != seconds ||
+        tickRuns.back().count == std::numeric_limits<std::uint32_t>::max()) {
+        tickRuns.push_back(TickRun{seconds, 0});
+    }
+    ++tickRuns.back().count;
+    ++tickCount;
+}
+
+void ReplayLog::addCommand(ReplayCommand command) {
+    command.tick = static_cast<std::uint32_t>(tickCount);
+    commands.push_back(command);
+}
+
+bool ReplayLog::save(const std::string& path) const {
+    ArchiveWriter archive;
+    archive.clear();
+
+    archive.beginSection(archiveTag("RPLY"), 1);
+    archive.writeColumn(archiveTag("SEED"), &seed, 1);
+    archive.writeColumn(archiveTag("TCKS"), &tickCount, 1);
+    archive.endSection();
+
+    std::vector<double> seconds;
+    std::vector<std::uint32_t> counts;
+    for (const TickRun& run : tickRuns) {
+        seconds.push_back(run.seconds);
+        counts.push_back(run.count);
+    }
+    archive.beginSection(archiveTag("TICK"), static_cast<std::uint32_t>(tickRuns.size()));
+    archive.writeColumn(archiveTag("SECS"), seconds);
+    archive.writeColumn(archiveTag("CNT "), counts);
+    archive.endSection();
+
+    std::vector<std::uint32_t> ticks, types;
+    std::vector<std::int32_t> players, targets;
+    std::vector<double> values;
+    for (const ReplayCommand& command : commands) {
+        ticks.push_back(command.tick);
+        types.push_back(command.type);
+        players.push_back(command.player);
+        targets.push_back(command.target);
+        values.insert(values.end(), command.values, command.values + ReplayCommand::kValues);
+    }
+    archive.beginSection(archiveTag("CMDS"), static_cast<std::uint32_t>(commands.size()));
+    archive.writeColumn(archiveTag("TICK"), ticks);
+    archive.writeColumn(archiveTag("TYPE"), types);
+    archive.writeColumn(archiveTag("PLYR"), players);
+    archive.writeColumn(archiveTag("TRGT"), targets);
+    archive.writeColumn(archiveTag("VALS"), values);
+    archive.endSection();
+
+    const std::vector<std::uint8_t>& bytes = archive.finish(kVersion);
+    return writeFileAtomically(path, bytes.data(), bytes.size());
+}
+
+bool ReplayLog::load(const std::string& path) {
+    clear();
+    ArchiveReader reader;
+    ArchiveReader::Section header, ticks, commandSection;
+    if (!reader.readFile(path) || reader.getVersion() > kVersion || !reader.findSection(archiveTag("RPLY"), header) ||
+        !reader.findSection(archiveTag("TICK"), ticks) || !reader.findSection(archiveTag("CMDS"), commandSection)) {
+        return false;
+    }
+
+    std::vector<std::uint64_t> seeds, totals;
+    std::vector<double> seconds, values;
+    std::vector<std::uint32_t> counts, commandTicks, types;
+    std::vector<std::int32_t> players, targets;
+    std::size_t commandCount = commandSection.rowCount;
+    bool complete = reader.readColumn(header, archiveTag("SEED"), seeds) && seeds.size() == 1 &&
+                    reader.readColumn(header, archiveTag("TCKS"), totals) && totals.size() == 1 &&
+                    reader.readColumn(ticks, archiveTag("SECS"), seconds) && seconds.size() == ticks.rowCount &&
+                    reader.readColumn(ticks, archiveTag("CNT "), counts) && counts.size() == ticks.rowCount &&
+                    reader.readColumn(commandSection, archiveTag("TICK"), commandTicks) &&
+                    reader.readColumn(commandSection, archiveTag("TYPE"), types) &&
+                    reader.readColumn(commandSection, archiveTag("PLYR"), players) &&
+                    reader.readColumn(commandSection, archiveTag("TRGT"), targets) &&
+                    reader.readColumn(commandSection, archiveTag("VALS"), values) &&
+                    commandTicks.size() == commandCount && types.size() == commandCount &&
+                    players.size() == commandCount && targets.size() == commandCount &&
+                    values.size() == commandCount * ReplayCommand::kValues;
+    if (!complete) {
+        return false;
+    }
+
+    seed = seeds[0];
+    for (std::size_t i = 0; i < seconds.size(); ++i) {
+        tickRuns.push_back(TickRun{seconds[i], counts[i]});
+        tickCount += counts[i];
+    }
+    if (tickCount != totals[0]) {
+        clear();
+        return false;
+    }
+    commands.resize(commandCount);
+    for (std::size_t i = 0; i < commandCount; ++i) {
+        ReplayCommand& command = commands[i];
+        command.tick = commandTicks[i];
+        command.type = types[i];
+        command.player = players[i];
+        command.target = targets[i];
+        std::copy(values.begin() + i * ReplayCommand::kValues, values.begin() + (i + 1) * ReplayCommand::kValues,
+                  command.values);
+    }
+    return true;
+}
+
+std::uint64_t ReplayLog::replay(const std::function<void(const ReplayCommand&)>& applyCommand,
+                                const std::function<void(double)>& step) const {
+    std::uint64_t tick = 0;
+    std::size_t nextCommand = 0;
+    for (const TickRun& run : tickRuns) {
+        for (std::uint32_t i = 0; i < run.count; ++i, ++tick) {
+            while (nextCommand < commands.size() && commands[nextCommand].tick <= tick) {
+                applyCommand(commands[nextCommand++]);
+            }
+            step(run.seconds);
+        }
+    }
+    // Commands issued after the last tick still change the final state
+    while (nextCommand < commands.size()) {
+        applyCommand(commands[nextCommand++]);
+    }
+    return tick;
+}
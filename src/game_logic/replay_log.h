@@ -0,0 +1,75 @@
+// replay_log.h
+#ifndef REPLAY_LOG_H
+#define REPLAY_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// A player action, applied between simulation ticks.
+struct ReplayCommand {
+    enum Type : std::uint32_t {
+        FleetOrder = 0,   // target: ship id, values: destination x, y
+        Allocation = 1,   // target: planet id, values: share of metal per resource slot
+        Research = 2      // target: technology index, values: funds
+    };
+    static constexpr int kValues = 5;
+
+    std::uint32_t tick = 0;   // applied before this tick is simulated
+    std::uint32_t type = FleetOrder;
+    std::int32_t player = -1;
+    std::int32_t target = -1;
+    double values[kValues] = {};
+};
+
+// Everything needed to re-simulate a game: the random seed, the length of every
+// simulation tick and the commands applied between ticks. With the same seed, the
+// same ticks and the same commands, the simulation reaches the same state.
+//
+// Tick lengths are stored run-length encoded, so a fixed-step game is a single run.
+// Files are binary archives (utility/binary_archive.h):
+//   "RPLY"  one row: SEED, TCKS (tick count)
+//   "TICK"  one row per run: SECS, CNT
+//   "CMDS"  one row per command: TICK, TYPE, PLYR, TRGT, VALS (kValues per row)
+class ReplayLog {
+public:
+    static constexpr std::uint32_t kVersion = 1;
+
+    void clear();
+
+    void setSeed(std::uint64_t seed) { this->seed = seed; }
+    std::uint64_t getSeed() const { return seed; }
+
+    // Call after each simulated tick.
+    void addTick(double seconds);
+    // Stamps the command with the next tick to be simulated.
+    void addCommand(ReplayCommand command);
+
+    std::uint64_t getTickCount() const { return tickCount; }
+    const std::vector<ReplayCommand>& getCommands() const { return commands; }
+
+    bool save(const std::string& path) const;
+    // False if the file is missing, damaged or from a newer version; the log is then empty.
+    bool load(const std::string& path);
+
+    // Re-simulates as fast as the callbacks run: before each tick every command stamped
+    // with it goes to applyCommand, then step(seconds) advances the simulation. Seeding
+    // is left to the caller. Returns the number of ticks stepped.
+    std::uint64_t replay(const std::function<void(const ReplayCommand&)>& applyCommand,
+                         const std::function<void(double)>& step) const;
+
+private:
+    struct TickRun {
+        double seconds;
+        std::uint32_t count;
+    };
+
+    std::uint64_t seed = 0;
+    std::uint64_t tickCount = 0;
+    std::vector<TickRun> tickRuns;
+    std::vector<ReplayCommand> commands;
+};
+
+#endif
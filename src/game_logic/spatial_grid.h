@@ -0,0 +1,313 @@
+// spatial_grid.h
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Galaxy-wide uniform grid for proximity queries on ships and planets.
+// Items are bucketed by cell; only occupied cells are stored, so the grid
+// covers an unbounded galaxy. move() is incremental: an item is only relinked
+// when it crosses into a different cell.
+// T is the item handle (a ship pointer or a planet/ship index) and must be hashable.
+template <typename T>
+class SpatialGrid {
+public:
+    enum OwnerFilter {
+        AnyOwner,
+        SameOwner,
+        OtherOwner
+    };
+
+    explicit SpatialGrid(float cellSize = 64.0f) : cellSize(cellSize), inverseCellSize(1.0f / cellSize) {}
+
+    // Only valid while the grid is empty; cell keys depend on the cell size.
+    void setCellSize(float size) {
+        cellSize = size;
+        inverseCellSize = 1.0f / size;
+    }
+
+    float getCellSize() const { return cellSize; }
+    std::size_t size() const { return entries.size(); }
+    bool contains(const T& item) const { return slotOf.count(item) != 0; }
+
+    void clear() {
+        entries.clear();
+        slotOf.clear();
+        cells.clear();
+        occupiedColumns.clear();
+        occupiedRows.clear();
+    }
+
+    void insert(const T& item, float x, float y, int owner) {
+        if (contains(item)) {
+            move(item, x, y);
+            setOwner(item, owner);
+            return;
+        }
+        Entry entry;
+        entry.item = item;
+        entry.x = x;
+        entry.y = y;
+        entry.owner = owner;
+        entry.cellKey = keyFor(x, y);
+        std::vector<int>& cell = occupyCell(entry.cellKey);
+        entry.positionInCell = static_cast<int>(cell.size());
+        cell.push_back(static_cast<int>(entries.size()));
+        slotOf[item] = static_cast<int>(entries.size());
+        entries.push_back(entry);
+    }
+
+    void move(const T& item, float x, float y) {
+        auto found = slotOf.find(item);
+        if (found == slotOf.end()) {
+            return;
+        }
+        Entry& entry = entries[found->second];
+        entry.x = x;
+        entry.y = y;
+        std::int64_t newKey = keyFor(x, y);
+        if (newKey == entry.cellKey) {
+            return;
+        }
+        unlinkFromCell(found->second);
+        entry.cellKey = newKey;
+        std::vector<int>& cell = occupyCell(newKey);
+        entry.positionInCell = static_cast<int>(cell.size());
+        cell.push_back(found->second);
+    }
+
+    void setOwner(const T& item, int owner) {
+        auto found = slotOf.find(item);
+        if (found != slotOf.end()) {
+            entries[found->second].owner = owner;
+        }
+    }
+
+    void remove(const T& item) {
+        auto found = slotOf.find(item);
+        if (found == slotOf.end()) {
+            return;
+        }
+        int slot = found->second;
+        unlinkFromCell(slot);
+        slotOf.erase(found);
+
+        // Swap-remove from the dense entry array and patch the moved entry's references.
+        int last = static_cast<int>(entries.size()) - 1;
+        if (slot != last) {
+            entries[slot] = entries[last];
+            slotOf[entries[slot].item] = slot;
+            cells[entries[slot].cellKey][entries[slot].positionInCell] = slot;
+        }
+        entries.pop_back();
+    }
+
+    // Appends every item within radius of (x, y) that passes the owner filter. out is
+    // any vector of T, e.g. a std::pmr::vector on a frame arena.
+    template <typename Container>
+    void queryRadius(float x, float y, float radius, Container& out,
+                     OwnerFilter filter = AnyOwner, int owner = -1) const {
+        if (cells.empty()) {
+            return;
+        }
+        // Clamped to the occupied cells, so a huge radius costs no more than the grid's extent
+        const float radiusSquared = radius * radius;
+        const int minCellX = std::max(cellCoordinate(x - radius), occupiedColumns.begin()->first);
+        const int maxCellX = std::min(cellCoordinate(x + radius), occupiedColumns.rbegin()->first);
+        const int minCellY = std::max(cellCoordinate(y - radius), occupiedRows.begin()->first);
+        const int maxCellY = std::min(cellCoordinate(y + radius), occupiedRows.rbegin()->first);
+
+        for (int cellY = minCellY; cellY <= maxCellY; ++cellY) {
+            for (int cellX = minCellX; cellX <= maxCellX; ++cellX) {
+                auto cell = cells.find(packKey(cellX, cellY));
+                if (cell == cells.end()) {
+                    continue;
+                }
+                for (int slot : cell->second) {
+                    const Entry& entry = entries[slot];
+                    if (!passesFilter(entry, filter, owner)) {
+                        continue;
+                    }
+                    float dx = entry.x - x;
+                    float dy = entry.y - y;
+                    if (dx * dx + dy * dy <= radiusSquared) {
+                        out.push_back(entry.item);
+                    }
+                }
+            }
+        }
+    }
+
+    // Appends up to k items nearest to (x, y), closest first. maxRadius <= 0 means unbounded.
+    void queryNearest(float x, float y, std::size_t k, std::vector<T>& out,
+                      OwnerFilter filter = AnyOwner, int owner = -1, float maxRadius = 0.0f,
+                      const T* exclude = nullptr) const {
+        if (k == 0 || entries.empty()) {
+            return;
+        }
+
+        const int centerX = cellCoordinate(x);
+        const int centerY = cellCoordinate(y);
+        const float maxRadiusSquared = maxRadius > 0.0f ? maxRadius * maxRadius : -1.0f;
+        const int coverAll = ringsToCoverAll(centerX, centerY);
+        const int maxRing = maxRadius > 0.0f
+                                ? std::min(static_cast<int>(std::ceil(maxRadius * inverseCellSize)) + 1, coverAll)
+                                : coverAll;
+
+        std::vector<std::pair<float, int>> candidates;
+
+        for (int ring = 0; ring <= maxRing; ++ring) {
+            for (int cellY = centerY - ring; cellY <= centerY + ring; ++cellY) {
+                const bool edgeRow = cellY == centerY - ring || cellY == centerY + ring;
+                const int step = edgeRow ? 1 : 2 * ring;
+                for (int cellX = centerX - ring; cellX <= centerX + ring; cellX += (step > 0 ? step : 1)) {
+                    collectCell(cellX, cellY, x, y, filter, owner, maxRadiusSquared, exclude, candidates);
+                }
+            }
+
+            // Anything in a later ring is at least ring * cellSize away from (x, y).
+            if (candidates.size() >= k) {
+                std::nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end());
+                const float reach = ring * cellSize;
+                if (candidates[k - 1].first <= reach * reach) {
+                    break;
+                }
+            }
+        }
+
+        std::size_t count = std::min(k, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+        for (std::size_t i = 0; i < count; ++i) {
+            out.push_back(entries[candidates[i].second].item);
+        }
+    }
+
+    bool findNearest(float x, float y, T& result, OwnerFilter filter = AnyOwner, int owner = -1,
+                     float maxRadius = 0.0f, const T* exclude = nullptr) const {
+        std::vector<T> nearest;
+        queryNearest(x, y, 1, nearest, filter, owner, maxRadius, exclude);
+        if (nearest.empty()) {
+            return false;
+        }
+        result = nearest.front();
+        return true;
+    }
+
+private:
+    struct Entry {
+        T item;
+        float x;
+        float y;
+        int owner;
+        std::int64_t cellKey;
+        int positionInCell;
+    };
+
+    int cellCoordinate(float value) const {
+        return static_cast<int>(std::floor(value * inverseCellSize));
+    }
+
+    static std::int64_t packKey(int cellX, int cellY) {
+        std::uint64_t high = static_cast<std::uint64_t>(static_cast<std::uint32_t>(cellX)) << 32;
+        return static_cast<std::int64_t>(high | static_cast<std::uint32_t>(cellY));
+    }
+
+    std::int64_t keyFor(float x, float y) const {
+        return packKey(cellCoordinate(x), cellCoordinate(y));
+    }
+
+    static bool passesFilter(const Entry& entry, OwnerFilter filter, int owner) {
+        switch (filter) {
+            case SameOwner: return entry.owner == owner;
+            case OtherOwner: return entry.owner != owner;
+            default: return true;
+        }
+    }
+
+    void unlinkFromCell(int slot) {
+        Entry& entry = entries[slot];
+        auto cell = cells.find(entry.cellKey);
+        std::vector<int>& members = cell->second;
+        int lastSlot = members.back();
+        members[entry.positionInCell] = lastSlot;
+        entries[lastSlot].positionInCell = entry.positionInCell;
+        members.pop_back();
+        if (members.empty()) {
+            trackCell(entry.cellKey, -1);
+            cells.erase(cell);
+        }
+    }
+
+    void collectCell(int cellX, int cellY, float x, float y, OwnerFilter filter, int owner,
+                     float maxRadiusSquared, const T* exclude,
+                     std::vector<std::pair<float, int>>& candidates) const {
+        auto cell = cells.find(packKey(cellX, cellY));
+        if (cell == cells.end()) {
+            return;
+        }
+        for (int slot : cell->second) {
+            const Entry& entry = entries[slot];
+            if (!passesFilter(entry, filter, owner) || (exclude != nullptr && entry.item == *exclude)) {
+                continue;
+            }
+            float dx = entry.x - x;
+            float dy = entry.y - y;
+            float distanceSquared = dx * dx + dy * dy;
+            if (maxRadiusSquared < 0.0f || distanceSquared <= maxRadiusSquared) {
+                candidates.emplace_back(distanceSquared, slot);
+            }
+        }
+    }
+
+    std::vector<int>& occupyCell(std::int64_t key) {
+        std::vector<int>& cell = cells[key];
+        if (cell.empty()) {
+            trackCell(key, 1);
+        }
+        return cell;
+    }
+
+    // Keeps a count of occupied cells per column and per row, so the occupied bounds
+    // shrink again when the outermost cells empty.
+    void trackCell(std::int64_t key, int delta) {
+        int cellX = static_cast<std::int32_t>(static_cast<std::uint32_t>(static_cast<std::uint64_t>(key) >> 32));
+        int cellY = static_cast<std::int32_t>(static_cast<std::uint32_t>(key));
+        adjustCount(occupiedColumns, cellX, delta);
+        adjustCount(occupiedRows, cellY, delta);
+    }
+
+    static void adjustCount(std::map<int, int>& counts, int coordinate, int delta) {
+        int& count = counts[coordinate];
+        count += delta;
+        if (count == 0) {
+            counts.erase(coordinate);
+        }
+    }
+
+    // Rings around (centerX, centerY) needed to reach every occupied cell.
+    int ringsToCoverAll(int centerX, int centerY) const {
+        int reachX = std::max(std::abs(occupiedColumns.begin()->first - centerX),
+                              std::abs(occupiedColumns.rbegin()->first - centerX));
+        int reachY = std::max(std::abs(occupiedRows.begin()->first - centerY),
+                              std::abs(occupiedRows.rbegin()->first - centerY));
+        return std::max(reachX, reachY);
+    }
+
+    float cellSize;
+    float inverseCellSize;
+    std::vector<Entry> entries;
+    std::unordered_map<T, int> slotOf;
+    std::unordered_map<std::int64_t, std::vector<int>> cells;
+    // Occupied cells per cell column and per cell row
+    std::map<int, int> occupiedColumns;
+    std::map<int, int> occupiedRows;
+};
+
+#endif
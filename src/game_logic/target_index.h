@@ -0,0 +1,146 @@
+// target_index.h
+#ifndef TARGET_INDEX_H
+#define TARGET_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Indexed binary min-heap of battle targets keyed on hull strength.
+// top() is the weakest ship; ties go to the ship inserted first, which matches a
+// front-to-back scan keeping the first strictly weaker ship. update() re-keys one
+// ship in O(log n) after it takes damage, so picking a target never rescans the fleet.
+// T is the ship handle (a ship pointer) and must be hashable.
+template <typename T>
+class TargetIndex {
+public:
+    void reserve(std::size_t count) {
+        heap.reserve(count);
+        positionOf.reserve(count);
+    }
+
+    void clear() {
+        heap.clear();
+        positionOf.clear();
+        nextOrder = 0;
+    }
+
+    std::size_t size() const { return heap.size(); }
+    bool empty() const { return heap.empty(); }
+    bool contains(const T& item) const { return positionOf.count(item) != 0; }
+
+    const T& top() const { return heap.front().item; }
+    double topStrength() const { return heap.front().strength; }
+
+    void insert(const T& item, double strength) {
+        if (contains(item)) {
+            update(item, strength);
+            return;
+        }
+        heap.push_back(Node{strength, nextOrder++, item});
+        positionOf[item] = heap.size() - 1;
+        siftUp(heap.size() - 1);
+    }
+
+    void update(const T& item, double strength) {
+        auto found = positionOf.find(item);
+        if (found == positionOf.end()) {
+            return;
+        }
+        std::size_t position = found->second;
+        double previous = heap[position].strength;
+        heap[position].strength = strength;
+        if (strength < previous) {
+            siftUp(position);
+        } else if (strength > previous) {
+            siftDown(position);
+        }
+    }
+
+    void pop() {
+        removeAt(0);
+    }
+
+    bool remove(const T& item) {
+        auto found = positionOf.find(item);
+        if (found == positionOf.end()) {
+            return false;
+        }
+        removeAt(found->second);
+        return true;
+    }
+
+private:
+    struct Node {
+        double strength;
+        std::uint64_t order;
+        T item;
+    };
+
+    static bool weaker(const Node& a, const Node& b) {
+        return a.strength < b.strength || (a.strength == b.strength && a.order < b.order);
+    }
+
+    void removeAt(std::size_t position) {
+        positionOf.erase(heap[position].item);
+        std::size_t last = heap.size() - 1;
+        if (position != last) {
+            heap[position] = std::move(heap[last]);
+            positionOf[heap[position].item] = position;
+            heap.pop_back();
+            siftUp(position);
+            siftDown(position);
+        } else {
+            heap.pop_back();
+        }
+    }
+
+    void place(std::size_t position, Node node) {
+        positionOf[node.item] = position;
+        heap[position] = std::move(node);
+    }
+
+    void siftUp(std::size_t position) {
+        Node node = heap[position];
+        while (position > 0) {
+            std::size_t parent = (position - 1) / 2;
+            if (!weaker(node, heap[parent])) {
+                break;
+            }
+            place(position, heap[parent]);
+            position = parent;
+        }
+        place(position, node);
+    }
+
+    void siftDown(std::size_t position) {
+        if (position >= heap.size()) {
+            return;
+        }
+        Node node = heap[position];
+        const std::size_t count = heap.size();
+        while (true) {
+            std::size_t child = 2 * position + 1;
+            if (child >= count) {
+                break;
+            }
+            if (child + 1 < count && weaker(heap[child + 1], heap[child])) {
+                ++child;
+            }
+            if (!weaker(heap[child], node)) {
+                break;
+            }
+            place(position, heap[child]);
+            position = child;
+        }
+        place(position, node);
+    }
+
+    std::vector<Node> heap;
+    std::unordered_map<T, std::size_t> positionOf;
+    std::uint64_t nextOrder = 0;
+};
+
+#endif
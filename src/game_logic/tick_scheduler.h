@@ -0,0 +1,138 @@
+// tick_scheduler.h
+#ifndef TICK_SCHEDULER_H
+#define TICK_SCHEDULER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../utility/metrics.h"
+#include "../utility/profiler.h"
+#include "../utility/worker_pool.h"
+
+// Job graph for one simulation tick.
+// Each phase declares the subsystems it reads and writes as a bitmask. Phases are
+// grouped into waves: a phase lands in the first wave after every earlier phase it
+// conflicts with (write/read, read/write or write/write), so conflicting phases keep
+// their declaration order and the result matches running them one after another.
+// Phases with an item count are split into [begin, end) chunks; such a phase must
+// only write the items inside its chunk.
+// Each phase's time, summed over its chunks, goes to the "tick.<name>.cpu_ns" counter.
+template <typename Owner>
+class TickScheduler {
+public:
+    using PhaseFunction = void (Owner::*)(double deltaTime, std::size_t begin, std::size_t end);
+    using CountFunction = std::size_t (Owner::*)() const;
+
+    struct Phase {
+        const char* name;
+        unsigned reads;
+        unsigned writes;
+        PhaseFunction run;
+        CountFunction itemCount;
+        std::size_t chunkSize;
+        MetricCounter* cpuNanoseconds;
+    };
+
+    void addPhase(const char* name, unsigned reads, unsigned writes, PhaseFunction run,
+                  CountFunction itemCount = nullptr, std::size_t chunkSize = 0) {
+        MetricCounter& cpuNanoseconds = metricsRegistry().counter(std::string("tick.") + name + ".cpu_ns");
+        phases.push_back(Phase{name, reads, writes, run, itemCount, chunkSize, &cpuNanoseconds});
+        wavesDirty = true;
+    }
+
+    void clear() {
+        phases.clear();
+        waves.clear();
+        wavesDirty = false;
+    }
+
+    void run(Owner& owner, double deltaTime, WorkerPool* pool) {
+        if (wavesDirty) {
+            buildWaves();
+        }
+
+        for (const std::vector<int>& wave : waves) {
+            jobs.clear();
+            for (int phaseIndex : wave) {
+                const Phase& phase = phases[phaseIndex];
+                if (phase.itemCount == nullptr || phase.chunkSize == 0) {
+                    std::size_t count = phase.itemCount != nullptr ? (owner.*phase.itemCount)() : 0;
+                    jobs.push_back(Job{phaseIndex, 0, count});
+                    continue;
+                }
+                std::size_t count = (owner.*phase.itemCount)();
+                for (std::size_t begin = 0; begin < count; begin += phase.chunkSize) {
+                    jobs.push_back(Job{phaseIndex, begin, std::min(count, begin + phase.chunkSize)});
+                }
+            }
+
+            if (pool == nullptr || jobs.size() <= 1) {
+                for (const Job& job : jobs) {
+                    runJob(owner, deltaTime, job);
+                }
+            } else {
+                pool->parallelFor(jobs.size(), [this, &owner, deltaTime](std::size_t jobIndex) {
+                    runJob(owner, deltaTime, jobs[jobIndex]);
+                });
+            }
+        }
+    }
+
+    const std::vector<Phase>& getPhases() const { return phases; }
+    const std::vector<std::vector<int>>& getWaves() {
+        if (wavesDirty) {
+            buildWaves();
+        }
+        return waves;
+    }
+
+private:
+    struct Job {
+        int phase;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    static bool conflicts(const Phase& earlier, const Phase& later) {
+        return (earlier.writes & (later.reads | later.writes)) != 0 || (earlier.reads & later.writes) != 0;
+    }
+
+    void runJob(Owner& owner, double deltaTime, const Job& job) {
+        const Phase& phase = phases[job.phase];
+        ProfileZone zone(phase.name);
+        auto start = std::chrono::steady_clock::now();
+        (owner.*phase.run)(deltaTime, job.begin, job.end);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        phase.cpuNanoseconds->add(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    void buildWaves() {
+        std::vector<int> level(phases.size(), 0);
+        int deepest = -1;
+        for (std::size_t later = 0; later < phases.size(); ++later) {
+            for (std::size_t earlier = 0; earlier < later; ++earlier) {
+                if (conflicts(phases[earlier], phases[later])) {
+                    level[later] = std::max(level[later], level[earlier] + 1);
+                }
+            }
+            deepest = std::max(deepest, level[later]);
+        }
+
+        waves.assign(deepest + 1, std::vector<int>());
+        for (std::size_t i = 0; i < phases.size(); ++i) {
+            waves[level[i]].push_back(static_cast<int>(i));
+        }
+        wavesDirty = false;
+    }
+
+    std::vector<Phase> phases;
+    std::vector<std::vector<int>> waves;
+    std::vector<Job> jobs;
+    bool wavesDirty = false;
+};
+
+#endif
@@ -0,0 +1,270 @@
+// visibility_system.cpp
+#include "visibility_system.h"
+
+#include <algorithm>
+
+VisibilitySystem::VisibilitySystem(const SpatialGrid<int>& planetGrid) : planetGrid(planetGrid) {}
+
+void VisibilitySystem::setPlayerCount(std::size_t count) {
+    std::size_t oldCount = players.size();
+    players.resize(count);
+    for (std::size_t player = oldCount; player < count; ++player) {
+        PlayerState& state = players[player];
+        state.planetCoverage.assign(planetOwners.size(), 0);
+        state.visiblePlanets.resize(planetOwners.size());
+        state.seenPlanets.resize(planetOwners.size());
+        state.seenOwnedByOther.resize(planetOwners.size());
+        state.visibleShips.resize(ships.size());
+        for (std::size_t planetId = 0; planetId < planetOwners.size(); ++planetId) {
+            if (planetOwners[planetId] == static_cast<int>(player)) {
+                addCoverage(static_cast<int>(player), static_cast<int>(planetId), 1);
+            }
+        }
+    }
+    // Sensors owned by the new players were left unapplied; re-applying them counts them now.
+    for (std::size_t shipId = 0; shipId < ships.size(); ++shipId) {
+        markSensorDirty(static_cast<int>(shipId));
+        markTargetDirty(static_cast<int>(shipId));
+    }
+}
+
+void VisibilitySystem::addPlanet(int planetId, float x, float y, int owner) {
+    // Applied sensor circles must match the ship grid before the new planet is counted.
+    update();
+
+    planetOwners.push_back(owner);
+    for (PlayerState& state : players) {
+        state.planetCoverage.push_back(0);
+        state.visiblePlanets.resize(planetOwners.size());
+        state.seenPlanets.resize(planetOwners.size());
+        state.seenOwnedByOther.resize(planetOwners.size());
+    }
+    if (isPlayer(owner)) {
+        addCoverage(owner, planetId, 1);
+    }
+
+    // Count every sensor that already covers the planet.
+    queryScratch.clear();
+    shipGrid.queryRadius(x, y, maxSensorRange, queryScratch);
+    for (int shipId : queryScratch) {
+        const ShipState& sensor = ships[shipId];
+        if (!isPlayer(sensor.appliedOwner) || sensor.appliedRange <= 0.0f) {
+            continue;
+        }
+        float dx = x - sensor.appliedX;
+        float dy = y - sensor.appliedY;
+        if (dx * dx + dy * dy <= sensor.appliedRange * sensor.appliedRange) {
+            addCoverage(sensor.appliedOwner, planetId, 1);
+        }
+    }
+}
+
+void VisibilitySystem::setPlanetOwner(int planetId, int owner) {
+    int previous = planetOwners[planetId];
+    if (previous == owner) {
+        return;
+    }
+    planetOwners[planetId] = owner;
+    if (isPlayer(previous)) {
+        addCoverage(previous, planetId, -1);
+    }
+    if (isPlayer(owner)) {
+        addCoverage(owner, planetId, 1);
+    }
+    // Whoever is watching sees the change of hands.
+    for (std::size_t player = 0; player < players.size(); ++player) {
+        if (players[player].visiblePlanets.test(planetId)) {
+            refreshOwnerBit(static_cast<int>(player), planetId);
+        }
+    }
+}
+
+void VisibilitySystem::clearPlanets() {
+    planetOwners.clear();
+    for (PlayerState& state : players) {
+        state.planetCoverage.clear();
+        state.visiblePlanets.resize(0);
+        state.seenPlanets.resize(0);
+        state.seenOwnedByOther.resize(0);
+    }
+}
+
+void VisibilitySystem::addShip(int shipId, float x, float y, int owner, float sensorRange) {
+    ShipState state;
+    state.x = x;
+    state.y = y;
+    state.range = sensorRange;
+    state.owner = owner;
+    state.appliedX = x;
+    state.appliedY = y;
+    state.appliedRange = 0.0f;
+    state.appliedOwner = -1;
+    state.dirtySensor = false;
+    state.dirtyTarget = false;
+    ships.push_back(state);
+    shipGrid.insert(shipId, x, y, owner);
+    maxSensorRange = std::max(maxSensorRange, sensorRange);
+
+    for (PlayerState& player : players) {
+        player.visibleShips.resize(ships.size());
+    }
+    markSensorDirty(shipId);
+    markTargetDirty(shipId);
+}
+
+void VisibilitySystem::moveShip(int shipId, float x, float y) {
+    ShipState& ship = ships[shipId];
+    if (ship.x == x && ship.y == y) {
+        return;
+    }
+    ship.x = x;
+    ship.y = y;
+    shipGrid.move(shipId, x, y);
+    markSensorDirty(shipId);
+    markTargetDirty(shipId);
+}
+
+void VisibilitySystem::setShipOwner(int shipId, int owner) {
+    ShipState& ship = ships[shipId];
+    if (ship.owner == owner) {
+        return;
+    }
+    ship.owner = owner;
+    shipGrid.setOwner(shipId, owner);
+    markSensorDirty(shipId);
+    markTargetDirty(shipId);
+}
+
+void VisibilitySystem::setSensorRange(int shipId, float sensorRange) {
+    ShipState& ship = ships[shipId];
+    if (ship.range == sensorRange) {
+        return;
+    }
+    ship.range = sensorRange;
+    maxSensorRange = std::max(maxSensorRange, sensorRange);
+    markSensorDirty(shipId);
+}
+
+void VisibilitySystem::clearShips() {
+    ships.clear();
+    shipGrid.clear();
+    dirtySensors.clear();
+    dirtyTargets.clear();
+    maxSensorRange = 0.0f;
+    for (std::size_t player = 0; player < players.size(); ++player) {
+        PlayerState& state = players[player];
+        state.visibleShips.resize(0);
+        // Only ownership is left covering planets.
+        std::fill(state.planetCoverage.begin(), state.planetCoverage.end(), 0);
+        state.visiblePlanets.clearAll();
+        for (std::size_t planetId = 0; planetId < planetOwners.size(); ++planetId) {
+            if (planetOwners[planetId] == static_cast<int>(player)) {
+                addCoverage(static_cast<int>(player), static_cast<int>(planetId), 1);
+            }
+        }
+    }
+}
+
+void VisibilitySystem::update() {
+    // dirtySensors does not grow while it is walked; markShipsInCircle only queues targets.
+    for (int shipId : dirtySensors) {
+        ShipState& sensor = ships[shipId];
+        sensor.dirtySensor = false;
+        if (isPlayer(sensor.appliedOwner) && sensor.appliedRange > 0.0f) {
+            coverPlanets(sensor.appliedOwner, sensor.appliedX, sensor.appliedY, sensor.appliedRange, -1);
+            markShipsInCircle(sensor.appliedX, sensor.appliedY, sensor.appliedRange);
+        }
+        sensor.appliedX = sensor.x;
+        sensor.appliedY = sensor.y;
+        sensor.appliedRange = sensor.range;
+        sensor.appliedOwner = isPlayer(sensor.owner) ? sensor.owner : -1;
+        if (isPlayer(sensor.appliedOwner) && sensor.appliedRange > 0.0f) {
+            coverPlanets(sensor.appliedOwner, sensor.appliedX, sensor.appliedY, sensor.appliedRange, 1);
+            markShipsInCircle(sensor.appliedX, sensor.appliedY, sensor.appliedRange);
+        }
+    }
+    dirtySensors.clear();
+
+    for (int shipId : dirtyTargets) {
+        ships[shipId].dirtyTarget = false;
+        recomputeShip(shipId);
+    }
+    dirtyTargets.clear();
+}
+
+void VisibilitySystem::markPlanetSeen(int player, int planetId) {
+    players[player].seenPlanets.set(planetId);
+    refreshOwnerBit(player, planetId);
+}
+
+void VisibilitySystem::markSensorDirty(int shipId) {
+    if (!ships[shipId].dirtySensor) {
+        ships[shipId].dirtySensor = true;
+        dirtySensors.push_back(shipId);
+    }
+}
+
+void VisibilitySystem::markTargetDirty(int shipId) {
+    if (!ships[shipId].dirtyTarget) {
+        ships[shipId].dirtyTarget = true;
+        dirtyTargets.push_back(shipId);
+    }
+}
+
+void VisibilitySystem::coverPlanets(int owner, float x, float y, float range, int delta) {
+    queryScratch.clear();
+    planetGrid.queryRadius(x, y, range, queryScratch);
+    for (int planetId : queryScratch) {
+        addCoverage(owner, planetId, delta);
+    }
+}
+
+void VisibilitySystem::addCoverage(int player, int planetId, int delta) {
+    PlayerState& state = players[player];
+    std::uint32_t& coverage = state.planetCoverage[planetId];
+    coverage += delta;
+    if (delta > 0 && coverage == static_cast<std::uint32_t>(delta)) {
+        state.visiblePlanets.set(planetId);
+        state.seenPlanets.set(planetId);
+        refreshOwnerBit(player, planetId);
+    } else if (coverage == 0) {
+        state.visiblePlanets.reset(planetId);
+    }
+}
+
+void VisibilitySystem::refreshOwnerBit(int player, int planetId) {
+    int owner = planetOwners[planetId];
+    players[player].seenOwnedByOther.assign(planetId, owner >= 0 && owner != player);
+}
+
+void VisibilitySystem::markShipsInCircle(float x, float y, float range) {
+    queryScratch.clear();
+    shipGrid.queryRadius(x, y, range, queryScratch);
+    for (int shipId : queryScratch) {
+        markTargetDirty(shipId);
+    }
+}
+
+void VisibilitySystem::recomputeShip(int shipId) {
+    const ShipState& target = ships[shipId];
+    for (PlayerState& player : players) {
+        player.visibleShips.reset(shipId);
+    }
+    if (isPlayer(target.owner)) {
+        players[target.owner].visibleShips.set(shipId);
+    }
+
+    queryScratch.clear();
+    shipGrid.queryRadius(target.x, target.y, maxSensorRange, queryScratch);
+    for (int sensorId : queryScratch) {
+        const ShipState& sensor = ships[sensorId];
+        if (!isPlayer(sensor.owner) || sensor.range <= 0.0f) {
+            continue;
+        }
+        float dx = target.x - sensor.x;
+        float dy = target.y - sensor.y;
+        if (dx * dx + dy * dy <= sensor.range * sensor.range) {
+            players[sensor.owner].visibleShips.set(shipId);
+        }
+    }
+}
@@ -0,0 +1,109 @@
+// visibility_system.h
+#ifndef VISIBILITY_SYSTEM_H
+#define VISIBILITY_SYSTEM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "entity_bitset.h"
+#include "spatial_grid.h"
+
+// Fog of war for every player, kept up to date incrementally.
+// Ships are the sensors: a ship sees every planet and ship within its sensor range.
+// Owners always see their own planets and ships. Each player gets three bitsets:
+//   visible planets  - covered by at least one of the player's sensors right now
+//   seen planets     - visible at some point (sticky)
+//   visible ships    - covered right now
+// plus a sticky "seen in the possession of another player" bit per planet, taken
+// from the owner at the time the planet was last visible.
+//
+// Moves, range changes and owner changes are queued and applied by update(). The
+// work done is proportional to what changed:
+//   - planets keep a per-player coverage count; a changed sensor subtracts its old
+//     circle and adds its new one,
+//   - only ships that moved, or that sit inside a changed sensor's old or new circle,
+//     have their visibility recomputed.
+// All queries are O(1) bit tests.
+class VisibilitySystem {
+public:
+    explicit VisibilitySystem(const SpatialGrid<int>& planetGrid);
+
+    // Grow-only; players are never removed mid-game.
+    void setPlayerCount(std::size_t count);
+    std::size_t getPlayerCount() const { return players.size(); }
+
+    // Planet ids are dense and match the planet grid. Call before the planet goes into
+    // the grid: pending sensor changes are applied first, against the grid as it was.
+    void addPlanet(int planetId, float x, float y, int owner);
+    void setPlanetOwner(int planetId, int owner);
+    void clearPlanets();
+
+    // Ship ids are dense, in the order the ships were added.
+    void addShip(int shipId, float x, float y, int owner, float sensorRange);
+    void moveShip(int shipId, float x, float y);
+    void setShipOwner(int shipId, int owner);
+    void setSensorRange(int shipId, float sensorRange);
+    float getSensorRange(int shipId) const { return ships[shipId].range; }
+    void clearShips();
+
+    // Applies every change queued since the last call.
+    void update();
+
+    // Marks a planet seen without a sensor covering it (map trades, espionage).
+    void markPlanetSeen(int player, int planetId);
+
+    bool isPlanetVisible(int player, int planetId) const { return players[player].visiblePlanets.test(planetId); }
+    bool hasSeenPlanet(int player, int planetId) const { return players[player].seenPlanets.test(planetId); }
+    bool hasSeenPlanetOwnedByOther(int player, int planetId) const {
+        return players[player].seenOwnedByOther.test(planetId);
+    }
+    bool isShipVisible(int player, int shipId) const { return players[player].visibleShips.test(shipId); }
+
+    const EntityBitset& getVisiblePlanets(int player) const { return players[player].visiblePlanets; }
+    const EntityBitset& getSeenPlanets(int player) const { return players[player].seenPlanets; }
+    const EntityBitset& getVisibleShips(int player) const { return players[player].visibleShips; }
+
+private:
+    struct PlayerState {
+        std::vector<std::uint32_t> planetCoverage;
+        EntityBitset visiblePlanets;
+        EntityBitset seenPlanets;
+        EntityBitset seenOwnedByOther;
+        EntityBitset visibleShips;
+    };
+
+    struct ShipState {
+        float x;
+        float y;
+        float range;
+        int owner;
+        // Circle currently counted in planetCoverage
+        float appliedX;
+        float appliedY;
+        float appliedRange;
+        int appliedOwner;
+        bool dirtySensor;
+        bool dirtyTarget;
+    };
+
+    bool isPlayer(int owner) const { return owner >= 0 && owner < static_cast<int>(players.size()); }
+    void markSensorDirty(int shipId);
+    void markTargetDirty(int shipId);
+    void coverPlanets(int owner, float x, float y, float range, int delta);
+    void addCoverage(int player, int planetId, int delta);
+    void refreshOwnerBit(int player, int planetId);
+    void markShipsInCircle(float x, float y, float range);
+    void recomputeShip(int shipId);
+
+    const SpatialGrid<int>& planetGrid;
+    SpatialGrid<int> shipGrid{64.0f};
+    std::vector<PlayerState> players;
+    std::vector<int> planetOwners;
+    std::vector<ShipState> ships;
+    std::vector<int> dirtySensors;
+    std::vector<int> dirtyTargets;
+    std::vector<int> queryScratch;
+    float maxSensorRange = 0.0f;
+};
+
+#endif
@@ -5,6 +5,10 @@
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_mixer.h>
+#include "utility/frame_arena.h"
+#include "utility/geometry_batch.h"
+#include "utility/metrics.h"
+#include "utility/random_streams.h"
 
 // Structs
 struct Planet {
@@ -2185,17 +2189,21 @@ public:
         initializePopulation();
     }
 
+    // Each generation is bred into one frame arena buffer, then moved over the population,
+    // which keeps its capacity, so only the offspring's genes allocate.
     std::vector<double> findBestSolution(int numGenerations) {
+        std::pmr::vector<Individual> newPopulation(&frameArena());
+        newPopulation.reserve(populationSize);
         for (int i = 0; i < numGenerations; ++i) {
-            std::vector<Individual> newPopulation;
+            newPopulation.clear();
             for (int j = 0; j < populationSize; ++j) {
                 Individual parent1 = selection();
                 Individual parent2 = selection();
                 Individual offspring = crossover(parent1, parent2);
                 mutate(offspring);
-                newPopulation.push_back(offspring);
+                newPopulation.push_back(std::move(offspring));
             }
-            population = newPopulation;
+            population.assign(std::make_move_iterator(newPopulation.begin()), std::make_move_iterator(newPopulation.end()));
         }
         return getBestIndividual().genes;
     }
@@ -2248,9 +2256,13 @@ public:
     double learningRate;
     double discountFactor;
     double explorationRate;
+    // Exploration draws only from this, so agents can learn in parallel and reproducibly
+    RandomStream explorationRandom;
 
-    QLearning(double learningRate, double discountFactor, double explorationRate)
-        : learningRate(learningRate), discountFactor(discountFactor), explorationRate(explorationRate) {}
+    QLearning(double learningRate, double discountFactor, double explorationRate,
+              const RandomStream& explorationRandom = RandomStream())
+        : learningRate(learningRate), discountFactor(discountFactor), explorationRate(explorationRate),
+          explorationRandom(explorationRandom) {}
 
     void learn(const State& state, const Action& action, double reward, const State& nextState) {
         double maxQNextState = getMaxQValue(nextState);
@@ -2294,7 +2306,7 @@ private:
     }
 
     double randomDouble() {
-        return static_cast<double>(rand()) / RAND_MAX;
+        return explorationRandom.nextDouble();
     }
 
     Action getRandomAction(const State& state) {
@@ -2371,11 +2383,11 @@ double clamp(double value, double min, double max) {
 }
 
 int randomInt(int min, int max) {
-    return min + rand() % (max - min + 1);
+    return threadRandomStream().nextInt(min, max);
 }
 
 double randomDouble(double min, double max) {
-    return min + (max - min) * (static_cast<double>(rand()) / RAND_MAX);
+    return threadRandomStream().nextDouble(min, max);
 }
 
 bool isInRange(double value, double min, double max) {
@@ -2697,6 +2709,9 @@ void GameState::handleMouseClick(const sf::Event::MouseButtonEvent& event) {
 
 // Game loop
 void GameState::update(double deltaTime) {
+    static MetricHistogram& tickTime = metricsRegistry().histogram("tick_us");
+    ScopedMetricTimer timer(tickTime);
+
     // Update game state
     updatePlanets(deltaTime);
     updateShips(deltaTime);
@@ -2706,6 +2721,8 @@ void GameState::update(double deltaTime) {
     triggerEvents();
     applyEventEffects();
     handleInput();
+
+    releaseFrameArenas();
 }
 
 void GameState::render() {
@@ -2807,21 +2824,102 @@ double Player::getTechEnergyCost(const std::string& techName) {
     return 0.0;
 }
 
+// Galaxy view draw state kept between frames: the star field and background are drawn
+// once into textures, and the planet batch keeps its capacity.
+struct GalaxyLayers {
+    TextureLayer background;
+    TextureLayer stars;
+    GeometryBatch planets;
+};
+
+GalaxyLayers& galaxyLayers() {
+    static GalaxyLayers layers;
+    return layers;
+}
+
+// Metrics overlay, toggled with F3: every registered metric, counters and histograms
+// over the turn so far.
+struct MetricsOverlay {
+    bool visible = false;
+    TTF_Font* font = nullptr;
+
+    void release() {
+        if (font != nullptr) {
+            TTF_CloseFont(font);
+            font = nullptr;
+        }
+    }
+};
+
+MetricsOverlay& metricsOverlay() {
+    static MetricsOverlay overlay;
+    return overlay;
+}
+
+void drawMetricsOverlay(SDL_Renderer* renderer) {
+    MetricsOverlay& overlay = metricsOverlay();
+    if (!overlay.visible) {
+        return;
+    }
+    if (overlay.font == nullptr && (overlay.font = TTF_OpenFont("font.ttf", 14)) == nullptr) {
+        return;
+    }
+
+    std::vector<MetricSample> samples = metricsRegistry().collect(false);
+    int lineHeight = TTF_FontLineSkip(overlay.font);
+    SDL_Rect panel = { WINDOW_WIDTH - 430, 10, 420, lineHeight * static_cast<int>(samples.size()) + 8 };
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+    SDL_RenderFillRect(renderer, &panel);
+
+    SDL_Color color = { 255, 255, 255, 255 };
+    int y = panel.y + 4;
+    for (const MetricSample& sample : samples) {
+        SDL_Surface* surface = TTF_RenderText_Blended(overlay.font, formatMetricSample(sample).c_str(), color);
+        if (surface != nullptr) {
+            SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+            SDL_Rect destRect = { panel.x + 6, y, surface->w, surface->h };
+            SDL_RenderCopy(renderer, texture, NULL, &destRect);
+            SDL_DestroyTexture(texture);
+            SDL_FreeSurface(surface);
+        }
+        y += lineHeight;
+    }
+}
+
+// A background star field placed from its own stream, so it does not move between frames.
+void drawStarField(SDL_Renderer* renderer) {
+    RandomStream starRandom = threadRandomStream().split(4);
+    GeometryBatch field;
+    for (int i = 0; i < 100; i++) {
+        float x = static_cast<float>(starRandom.nextInt(0, 1023));
+        float y = static_cast<float>(starRandom.nextInt(0, 767));
+        field.addPoint(x, y, {255, 255, 255, 255});
+    }
+    field.draw(renderer);
+}
+
 void GameState::renderGalaxy() {
     // Render the galaxy background
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
     // Render stars
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    for (const auto& star : stars) {
-        SDL_RenderDrawPoint(renderer, star.x, star.y);
-    }
+    galaxyLayers().stars.draw(renderer, WINDOW_WIDTH, WINDOW_HEIGHT, [this](SDL_Renderer* target) {
+        GeometryBatch field;
+        for (const auto& star : stars) {
+            field.addPoint(star.x, star.y, {255, 255, 255, 255});
+        }
+        field.draw(target);
+    });
 
     // Render planets
+    GeometryBatch& planetBatch = galaxyLayers().planets;
+    planetBatch.clear();
     for (Planet* planet : planets) {
-        planet->render(renderer);
+        planet->addTo(planetBatch);
     }
+    planetBatch.draw(renderer);
 
     // Render ships
     for (Ship* ship : ships) {
@@ -2871,6 +2969,11 @@ public:
         SDL_RenderFillCircle(renderer, position.x, position.y, radius);
     }
 
+    // Queues the planet for its layer's single draw call instead of drawing it now
+    void addTo(GeometryBatch& batch) const {
+        batch.addCircle(position.x, position.y, radius, {color.r, color.g, color.b, 255});
+    }
+
 private:
     double colonizationCost;
     double researchOutput;
@@ -3017,17 +3120,20 @@ void Technology::applyEffects(Player* player) {
 
 class RandomEvent : public GameEvent {
 public:
-    RandomEvent(const std::string& name, double probability)
-        : GameEvent(name), probability(probability) {}
+    // Each event rolls its own stream, so adding or reordering events does not change
+    // when the others fire.
+    RandomEvent(const std::string& name, double probability, const RandomStream& random = RandomStream())
+        : GameEvent(name), probability(probability), random(random) {}
 
     void trigger() override {
-        if (randomDouble(0.0, 1.0) < probability) {
+        if (random.nextDouble() < probability) {
             applyEffects();
         }
     }
 
 private:
     double probability;
+    RandomStream random;
 };
 
 class TimedEvent : public GameEvent {
@@ -3054,13 +3160,17 @@ void GameState::load(const std::string& filename) {
     // ...
 
     // Create random events
-    events.push_back(new RandomEvent("Solar Flare", 0.01));
-    events.push_back(new RandomEvent("Asteroid Field", 0.05));
-    events.push_back(new RandomEvent("Pirate Attack", 0.03));
+    RandomStream& eventRandom = threadRandomStream();
+    events.push_back(new RandomEvent("Solar Flare", 0.01, eventRandom.split(1)));
+    events.push_back(new RandomEvent("Asteroid Field", 0.05, eventRandom.split(2)));
+    events.push_back(new RandomEvent("Pirate Attack", 0.03, eventRandom.split(3)));
 
     // Create timed events
     events.push_back(new TimedEvent("Resource Boost", 60.0));
     events.push_back(new TimedEvent("Technology Breakthrough", 120.0));
+
+    // A loaded galaxy has its own star field
+    galaxyLayers().stars.invalidate();
 }
 class TechnologyBreakthroughEvent : public TimedEvent {
 public:
@@ -3075,7 +3185,7 @@ public:
         // Unlock a random technology
         std::vector<Technology> unlockedTechnologies = player.getUnlockedTechnologies();
         if (!unlockedTechnologies.empty()) {
-            int randomIndex = rand() % unlockedTechnologies.size();
+            int randomIndex = randomInt(0, static_cast<int>(unlockedTechnologies.size()) - 1);
             player.unlockTechnology(unlockedTechnologies[randomIndex]);
         }
     }
@@ -3194,7 +3304,7 @@ Technology* GameState::getRandomUnresearchedTechnology() {
         }
     }
     if (!unresearchedTechs.empty()) {
-        int randomIndex = rand() % unresearchedTechs.size();
+        int randomIndex = randomInt(0, static_cast<int>(unresearchedTechs.size()) - 1);
         return unresearchedTechs[randomIndex];
     }
     return nullptr;
@@ -3251,7 +3361,7 @@ void runGame() {
     // ...
 
     SDL_Window* window = SDL_CreateWindow("Spaceward Ho!", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1024, 768, SDL_WINDOW_SHOWN);
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
 
     // Game loop
     bool quit = false;
@@ -3264,6 +3374,9 @@ void runGame() {
                 quit = true;
             } else if (event.type == SDL_KEYDOWN) {
                 // Handle key press event
+                if (event.key.keysym.sym == SDLK_F3) {
+                    metricsOverlay().visible = !metricsOverlay().visible;
+                }
             } else if (event.type == SDL_MOUSEBUTTONDOWN) {
                 // Handle mouse click event
             }
@@ -3279,6 +3392,9 @@ void runGame() {
         SDL_RenderPresent(renderer);
     }
 
+    galaxyLayers().background.release();
+    galaxyLayers().stars.release();
+    metricsOverlay().release();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -3304,19 +3420,16 @@ void GameState::renderGalaxy(SDL_Renderer *renderer)
     SDL_RenderFillRect(renderer, &galaxyRect);
 
     // Render stars
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    for (int i = 0; i < 100; i++)
-    {
-        int x = rand() % 1024;
-        int y = rand() % 768;
-        SDL_RenderDrawPoint(renderer, x, y);
-    }
+    galaxyLayers().stars.draw(renderer, 1024, 768, drawStarField);
 }
 
 void GameState::renderPlanets(SDL_Renderer* renderer) {
+    GeometryBatch& batch = galaxyLayers().planets;
+    batch.clear();
     for (Planet* planet : planets) {
-        planet->render(renderer);
+        planet->addTo(batch);
     }
+    batch.draw(renderer);
 }
 
 void GameState::render(SDL_Renderer* renderer) {
@@ -3338,19 +3451,16 @@ void GameState::renderGalaxy(SDL_Renderer *renderer)
     SDL_RenderFillRect(renderer, &galaxyRect);
 
     // Render stars
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    for (int i = 0; i < 100; i++)
-    {
-        int x = rand() % 1024;
-        int y = rand() % 768;
-        SDL_RenderDrawPoint(renderer, x, y);
-    }
+    galaxyLayers().stars.draw(renderer, 1024, 768, drawStarField);
 }
 
 void GameState::renderPlanets(SDL_Renderer* renderer) {
+    GeometryBatch& batch = galaxyLayers().planets;
+    batch.clear();
     for (Planet* planet : planets) {
-        planet->render(renderer);
+        planet->addTo(batch);
     }
+    batch.draw(renderer);
 }
 
 void GameState::renderGalaxy(SDL_Renderer *renderer)
@@ -3364,21 +3474,18 @@ void GameState::renderGalaxy(SDL_Renderer *renderer)
     SDL_RenderFillRect(renderer, &galaxyRect);
 
     // Render stars
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    for (int i = 0; i < 100; i++)
-    {
-        int x = rand() % 1024;
-        int y = rand() % 768;
-        SDL_RenderDrawPoint(renderer, x, y);
-    }
+    galaxyLayers().stars.draw(renderer, 1024, 768, drawStarField);
 }
 
 void GameState::renderPlanets(SDL_Renderer *renderer)
 {
+    GeometryBatch &batch = galaxyLayers().planets;
+    batch.clear();
     for (Planet *planet : planets)
     {
-        planet->render(renderer);
+        planet->addTo(batch);
     }
+    batch.draw(renderer);
 }
 
 void GameState::render(SDL_Renderer *renderer)
@@ -3394,7 +3501,7 @@ void GameState::render(SDL_Renderer *renderer)
 void runGame()
 {
     SDL_Window *window = SDL_CreateWindow("Spaceward Ho!", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_SHOWN);
-    SDL_Renderer *renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    SDL_Renderer *renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
 
     // Game loop
     bool quit = false;
@@ -3412,6 +3519,10 @@ void runGame()
             else if (event.type == SDL_KEYDOWN)
             {
                 // Handle key press event
+                if (event.key.keysym.sym == SDLK_F3)
+                {
+                    metricsOverlay().visible = !metricsOverlay().visible;
+                }
                 const Uint8 *keyboardState = SDL_GetKeyboardState(NULL);
                 if (keyboardState[SDL_SCANCODE_SPACE])
                 {
@@ -3440,6 +3551,9 @@ void runGame()
         SDL_RenderPresent(renderer);
     }
 
+    galaxyLayers().background.release();
+    galaxyLayers().stars.release();
+    metricsOverlay().release();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -3455,17 +3569,23 @@ void GameState::render(SDL_Renderer* renderer) {
 }
 
 void GameState::renderGalaxy(SDL_Renderer* renderer) {
-    // Render the galaxy background using SDL2 rendering functions
-    SDL_Texture* texture = IMG_LoadTexture(renderer, "galaxy_background.png");
-    SDL_Rect destRect = { 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT };
-    SDL_RenderCopy(renderer, texture, NULL, &destRect);
-    SDL_DestroyTexture(texture);
+    // Render the galaxy background using SDL2 rendering functions; the image is only
+    // loaded again when the layer's texture is lost
+    galaxyLayers().background.draw(renderer, WINDOW_WIDTH, WINDOW_HEIGHT, [](SDL_Renderer* target) {
+        SDL_Texture* texture = IMG_LoadTexture(target, "galaxy_background.png");
+        SDL_Rect destRect = { 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT };
+        SDL_RenderCopy(target, texture, NULL, &destRect);
+        SDL_DestroyTexture(texture);
+    });
 }
 
 void GameState::renderPlanets(SDL_Renderer* renderer) {
+    GeometryBatch& batch = galaxyLayers().planets;
+    batch.clear();
     for (Planet* planet : planets) {
-        planet->render(renderer);
+        planet->addTo(batch);
     }
+    batch.draw(renderer);
 }
 
 void GameState::renderShips(SDL_Renderer* renderer) {
@@ -3491,4 +3611,6 @@ void GameState::renderUI(SDL_Renderer* renderer) {
     SDL_FreeSurface(surface);
     SDL_DestroyTexture(texture);
     TTF_CloseFont(font);
+
+    drawMetricsOverlay(renderer);
 }
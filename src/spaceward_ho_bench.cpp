@@ -0,0 +1,743 @@
+// spaceward_ho_bench.cpp
+// Seeded micro-benchmarks for the simulation hot paths, reported as JSON so runs can
+// be compared between releases. Every input is generated from --seed, so two runs
+// with the same seed time exactly the same work.
+//
+//   spaceward_ho_bench [--seed S] [--filter text] [--min-time seconds] [--out file]
+//   spaceward_ho_bench --check
+//
+// --check instead runs the correctness checks (vectorised paths against their scalar
+// versions, save format round trips) and exits non-zero on a failure.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+#include "game_logic/battle_resolver.h"
+#include "game_logic/headless_match.h"
+#include "game_logic/planet_store.h"
+#include "game_logic/projectile_store.h"
+#include "game_logic/spatial_grid.h"
+#include "game_logic/visibility_system.h"
+#include "utility/archive_delta.h"
+#include "utility/async_file_writer.h"
+#include "utility/binary_archive.h"
+#include "utility/random_streams.h"
+#include "utility/save_journal.h"
+
+namespace {
+
+// Keeps the optimiser from discarding a benchmark's result.
+template <typename T>
+void keep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+class BenchmarkRunner {
+public:
+    BenchmarkRunner(std::string filter, double minSeconds) : filter(std::move(filter)), minSeconds(minSeconds) {}
+
+    // Repeats op in batches sized so each of kSamples samples lasts about minSeconds /
+    // kSamples, and records the median, fastest and slowest sample per operation.
+    void run(const std::string& name, std::int64_t size, const std::function<void()>& op) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) {
+            return;
+        }
+        using Clock = std::chrono::steady_clock;
+        const double sampleSeconds = minSeconds / kSamples;
+
+        op();
+        std::int64_t batch = 1;
+        for (;;) {
+            auto start = Clock::now();
+            for (std::int64_t i = 0; i < batch; ++i) {
+                op();
+            }
+            double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            if (elapsed >= sampleSeconds || batch >= (std::int64_t(1) << 30)) {
+                break;
+            }
+            batch = elapsed > 0.0 ? std::max(batch * 2, static_cast<std::int64_t>(batch * sampleSeconds / elapsed * 1.2))
+                                  : batch * 10;
+        }
+
+        std::vector<double> samples;
+        for (int sample = 0; sample < kSamples; ++sample) {
+            auto start = Clock::now();
+            for (std::int64_t i = 0; i < batch; ++i) {
+                op();
+            }
+            samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() / batch);
+        }
+        std::sort(samples.begin(), samples.end());
+        results.push_back({name, size, batch * kSamples, samples[kSamples / 2], samples.front(), samples.back()});
+        std::cerr << name << " [" << size << "]: " << samples[kSamples / 2] << " ns/op" << std::endl;
+    }
+
+    void writeJson(std::ostream& out, std::uint64_t seed) const {
+        out << "{\n  \"seed\": " << seed << ",\n  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& result = results[i];
+            out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name << "\", \"size\": " << result.size
+                << ", \"iterations\": " << result.iterations << ", \"ns_per_op\": " << result.median
+                << ", \"min_ns_per_op\": " << result.fastest << ", \"max_ns_per_op\": " << result.slowest << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    static constexpr int kSamples = 9;
+
+    struct Result {
+        std::string name;
+        std::int64_t size;
+        std::int64_t iterations;
+        double median;
+        double fastest;
+        double slowest;
+    };
+
+    std::string filter;
+    double minSeconds;
+    std::vector<Result> results;
+};
+
+HeadlessMatch::Settings matchSettings(int planets) {
+    HeadlessMatch::Settings settings;
+    settings.planets = planets;
+    settings.players = 8;
+    settings.mapSize = 1000.0f * std::max(1.0f, static_cast<float>(planets) / 1000.0f);
+    return settings;
+}
+
+// The planet phase of a galaxy tick: every planet's growth, production and income.
+void benchmarkPlanetUpdate(BenchmarkRunner& runner, std::uint64_t seed) {
+    for (int planets : {100, 1000, 10000}) {
+        PlanetStore store = HeadlessMatch(matchSettings(planets), seed).getPlanets();
+        runner.run("galaxy.planets_update", planets, [&] { store.update(1.0 / 60.0); });
+    }
+}
+
+// A whole AI-only game: economy steps, AI turns and every battle, to the end.
+void benchmarkMatch(BenchmarkRunner& runner, std::uint64_t seed) {
+    for (int planets : {100, 1000}) {
+        runner.run("ai.match", planets, [&] {
+            HeadlessMatch::Result result = HeadlessMatch(matchSettings(planets), seed).run();
+            keep(result.turns);
+        });
+    }
+}
+
+void benchmarkBattle(BenchmarkRunner& runner, std::uint64_t seed) {
+    for (int fleet : {10, 100, 1000, 10000}) {
+        RandomStream random = RandomStream(seed, 1).split(static_cast<std::uint64_t>(fleet));
+        std::vector<BattleResolver::Combatant> attackers;
+        std::vector<BattleResolver::Combatant> defenders;
+        for (int i = 0; i < fleet; ++i) {
+            attackers.push_back({random.nextInt(5, 20), random.nextInt(1, 5)});
+            defenders.push_back({random.nextInt(5, 20), random.nextInt(1, 5)});
+        }
+        runner.run("battle.resolve", fleet, [&] {
+            BattleResolver::Result result = BattleResolver::resolve(attackers, defenders);
+            keep(result.rounds);
+        });
+    }
+}
+
+// Targets are far enough away that nothing arrives while the benchmark runs.
+void benchmarkProjectiles(BenchmarkRunner& runner, std::uint64_t seed) {
+    for (int count : {1000, 10000, 100000}) {
+        RandomStream random = RandomStream(seed, 2).split(static_cast<std::uint64_t>(count));
+        ProjectileStore projectiles;
+        projectiles.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            float x = static_cast<float>(random.nextDouble(0.0, 1000.0));
+            float y = static_cast<float>(random.nextDouble(0.0, 1000.0));
+            projectiles.spawn(x, y, static_cast<float>(random.nextDouble(1.0, 5.0)), 1.0, PoolHandle(), PoolHandle());
+            projectiles.targetX[i] = x + 1.0e6f;
+            projectiles.targetY[i] = y - 1.0e6f;
+        }
+        runner.run("projectile.integrate", count, [&] { projectiles.integrate(1.0f / 60.0f); });
+    }
+}
+
+// The planet table as the save game lays it out.
+void writePlanets(const PlanetStore& store, ArchiveWriter& writer) {
+    writer.clear();
+    writer.beginSection(archiveTag("PLNT"), static_cast<std::uint32_t>(store.size()));
+    writer.writeColumn(archiveTag("X   "), store.x);
+    writer.writeColumn(archiveTag("Y   "), store.y);
+    writer.writeColumn(archiveTag("OWNR"), store.playerOwner);
+    writer.writeColumn(archiveTag("POP "), store.population);
+    writer.writeColumn(archiveTag("TEMP"), store.temperature);
+    writer.writeColumn(archiveTag("GRAV"), store.gravity);
+    writer.writeColumn(archiveTag("METL"), store.metal);
+    writer.writeColumn(archiveTag("ENRG"), store.energy);
+    writer.writeColumn(archiveTag("FOOD"), store.food);
+    writer.writeColumn(archiveTag("INFR"), store.infrastructure);
+    writer.writeColumn(archiveTag("DEFN"), store.defense);
+    writer.writeColumn(archiveTag("INCM"), store.incomeGenerated);
+    writer.writeColumn(archiveTag("DVTD"), store.devotedResources);
+    writer.endSection();
+    writer.finish(1);
+}
+
+bool readPlanets(const ArchiveReader& reader, PlanetStore& store) {
+    ArchiveReader::Section section;
+    if (!reader.findSection(archiveTag("PLNT"), section)) {
+        return false;
+    }
+    store.resize(section.rowCount);
+    return reader.readColumn(section, archiveTag("X   "), store.x) &&
+           reader.readColumn(section, archiveTag("Y   "), store.y) &&
+           reader.readColumn(section, archiveTag("OWNR"), store.playerOwner) &&
+           reader.readColumn(section, archiveTag("POP "), store.population) &&
+           reader.readColumn(section, archiveTag("TEMP"), store.temperature) &&
+           reader.readColumn(section, archiveTag("GRAV"), store.gravity) &&
+           reader.readColumn(section, archiveTag("METL"), store.metal) &&
+           reader.readColumn(section, archiveTag("ENRG"), store.energy) &&
+           reader.readColumn(section, archiveTag("FOOD"), store.food) &&
+           reader.readColumn(section, archiveTag("INFR"), store.infrastructure) &&
+           reader.readColumn(section, archiveTag("DEFN"), store.defense) &&
+           reader.readColumn(section, archiveTag("INCM"), store.incomeGenerated) &&
+           reader.readColumn(section, archiveTag("DVTD"), store.devotedResources);
+}
+
+void benchmarkSaveLoad(BenchmarkRunner& runner, std::uint64_t seed) {
+    for (int planets : {1000, 10000}) {
+        PlanetStore store = HeadlessMatch(matchSettings(planets), seed).getPlanets();
+        PlanetStore loaded;
+        ArchiveWriter writer;
+        runner.run("save.roundtrip", planets, [&] {
+            writePlanets(store, writer);
+            ArchiveReader reader;
+            if (!reader.open(writer.getBuffer().data(), writer.getBuffer().size()) || !readPlanets(reader, loaded)) {
+                std::cerr << "save.roundtrip: archive did not read back" << std::endl;
+                std::exit(1);
+            }
+        });
+
+        // One turn's journal entry: a percent of the planets changed since the last save
+        RandomStream random = RandomStream(seed, 3).split(static_cast<std::uint64_t>(planets));
+        ArchiveWriter previousWriter;
+        writePlanets(store, previousWriter);
+        for (int i = 0; i < planets / 100; ++i) {
+            int planet = random.nextInt(0, planets - 1);
+            store.population[planet] += 1;
+            store.playerOwner[planet] = random.nextInt(0, 7);
+        }
+        ArchiveWriter currentWriter;
+        writePlanets(store, currentWriter);
+        ArchiveReader previous;
+        ArchiveReader current;
+        previous.open(previousWriter.getBuffer().data(), previousWriter.getBuffer().size());
+        current.open(currentWriter.getBuffer().data(), currentWriter.getBuffer().size());
+        ArchiveWriter delta;
+        ArchiveWriter rebuilt;
+        runner.run("save.delta_roundtrip", planets, [&] {
+            encodeArchiveDelta(previous, current, {}, delta);
+            ArchiveReader deltaReader;
+            if (!deltaReader.open(delta.getBuffer().data(), delta.getBuffer().size()) ||
+                !applyArchiveDelta(previous, deltaReader, rebuilt)) {
+                std::cerr << "save.delta_roundtrip: delta did not apply" << std::endl;
+                std::exit(1);
+            }
+        });
+    }
+}
+
+// A small save with the shapes the delta has to handle: per-row columns of one and
+// several elements, a ragged count/value pair, a whole column, strings, and a section
+// that only some turns have.
+struct CheckSave {
+    std::vector<std::int32_t> x;
+    std::vector<double> income;
+    std::vector<std::vector<std::int32_t>> orbits;
+    std::vector<std::string> names;
+    std::vector<std::int32_t> settings;
+    std::vector<std::int32_t> ships;
+};
+
+const std::vector<RaggedColumns> kCheckRagged = {{archiveTag("PLNT"), archiveTag("ORBN"), archiveTag("ORBS")}};
+
+std::vector<std::uint8_t> writeCheckSave(const CheckSave& save) {
+    ArchiveWriter writer;
+    std::uint32_t rows = static_cast<std::uint32_t>(save.x.size());
+    std::vector<std::uint32_t> orbitCounts;
+    std::vector<std::int32_t> orbitValues;
+    std::vector<std::uint32_t> nameIds;
+    for (std::uint32_t row = 0; row < rows; ++row) {
+        orbitCounts.push_back(static_cast<std::uint32_t>(save.orbits[row].size()));
+        orbitValues.insert(orbitValues.end(), save.orbits[row].begin(), save.orbits[row].end());
+        nameIds.push_back(writer.addString(save.names[row]));
+    }
+    writer.beginSection(archiveTag("PLNT"), rows);
+    writer.writeColumn(archiveTag("X   "), save.x);
+    writer.writeColumn(archiveTag("INCM"), save.income);
+    writer.writeColumn(archiveTag("ORBN"), orbitCounts);
+    writer.writeColumn(archiveTag("ORBS"), orbitValues);
+    writer.writeColumn(archiveTag("NAME"), nameIds);
+    writer.endSection();
+    if (!save.ships.empty()) {
+        writer.beginSection(archiveTag("SHIP"), static_cast<std::uint32_t>(save.ships.size()));
+        writer.writeColumn(archiveTag("OWNR"), save.ships);
+        writer.endSection();
+    }
+    writer.beginSection(archiveTag("GAME"), 1);
+    writer.writeColumn(archiveTag("SETT"), save.settings);
+    writer.endSection();
+    return writer.finish(1);
+}
+
+CheckSave makeCheckSave(int planets) {
+    CheckSave save;
+    for (int i = 0; i < planets; ++i) {
+        save.x.push_back(i * 10);
+        for (int slot = 0; slot < PlanetStore::kResourceSlots; ++slot) {
+            save.income.push_back(i + slot * 0.5);
+        }
+        save.orbits.push_back(std::vector<std::int32_t>(static_cast<std::size_t>(i % 3), i));
+        save.names.push_back("Planet " + std::to_string(i));
+    }
+    save.settings = {1, 2, 3};
+    return save;
+}
+
+void addCheckPlanet(CheckSave& save, int id) {
+    save.x.push_back(id * 7);
+    for (int slot = 0; slot < PlanetStore::kResourceSlots; ++slot) {
+        save.income.push_back(-id - slot);
+    }
+    save.orbits.push_back({id, id + 1});
+    save.names.push_back("Colony " + std::to_string(id));
+}
+
+void removeLastCheckPlanet(CheckSave& save) {
+    save.x.pop_back();
+    save.income.resize(save.income.size() - PlanetStore::kResourceSlots);
+    save.orbits.pop_back();
+    save.names.pop_back();
+}
+
+bool checkFailed(const std::string& name, const std::string& reason) {
+    std::cerr << "check " << name << ": " << reason << std::endl;
+    return false;
+}
+
+// The delta from previous to current must rebuild current byte for byte.
+bool checkDelta(const std::string& name, const CheckSave& previousSave, const CheckSave& currentSave) {
+    std::vector<std::uint8_t> previousBytes = writeCheckSave(previousSave);
+    std::vector<std::uint8_t> currentBytes = writeCheckSave(currentSave);
+    ArchiveReader previous;
+    ArchiveReader current;
+    if (!previous.open(previousBytes.data(), previousBytes.size()) || !current.open(currentBytes.data(), currentBytes.size())) {
+        return checkFailed(name, "archive did not open");
+    }
+    ArchiveWriter delta;
+    if (!encodeArchiveDelta(previous, current, kCheckRagged, delta)) {
+        return previousBytes == currentBytes ? true : checkFailed(name, "a change was not encoded");
+    }
+    ArchiveReader deltaReader;
+    ArchiveWriter rebuilt;
+    if (!deltaReader.open(delta.getBuffer().data(), delta.getBuffer().size()) ||
+        !applyArchiveDelta(previous, deltaReader, rebuilt)) {
+        return checkFailed(name, "delta did not apply");
+    }
+    if (rebuilt.getBuffer() != currentBytes) {
+        return checkFailed(name, "rebuilt archive differs from the saved one");
+    }
+    return true;
+}
+
+bool checkArchiveDeltas() {
+    bool passed = true;
+    CheckSave base = makeCheckSave(12);
+
+    CheckSave unchanged = base;
+    passed &= checkDelta("delta.unchanged", base, unchanged);
+
+    CheckSave edited = base;
+    edited.x[3] += 1;
+    edited.income[7 * PlanetStore::kResourceSlots + 2] = 99.0;
+    edited.settings[1] = 5;
+    passed &= checkDelta("delta.rows_changed", base, edited);
+
+    CheckSave grown = base;
+    addCheckPlanet(grown, 12);
+    addCheckPlanet(grown, 13);
+    passed &= checkDelta("delta.rows_added", base, grown);
+
+    CheckSave shrunk = base;
+    removeLastCheckPlanet(shrunk);
+    removeLastCheckPlanet(shrunk);
+    removeLastCheckPlanet(shrunk);
+    shrunk.x[0] = -1;
+    passed &= checkDelta("delta.rows_removed", base, shrunk);
+
+    CheckSave ragged = base;
+    ragged.orbits[1].push_back(50);
+    ragged.orbits[2].clear();
+    ragged.orbits[4] = {1, 2, 3, 4, 5, 6};
+    ragged.orbits[11].pop_back();
+    passed &= checkDelta("delta.ragged_lengths", base, ragged);
+
+    CheckSave renamed = base;
+    renamed.names[5] = "New Terra";
+    passed &= checkDelta("delta.strings", base, renamed);
+
+    // Fifteen characters before and after, so CHRS divides evenly by the string count
+    CheckSave evenNames = makeCheckSave(3);
+    evenNames.names = {"Alice", "Bobby", "Carol"};
+    CheckSave evenRenamed = evenNames;
+    evenRenamed.names = {"Alice", "Bob", "Carolyn"};
+    passed &= checkDelta("delta.strings_even", evenNames, evenRenamed);
+
+    CheckSave withShips = base;
+    withShips.ships = {0, 1, 1, 2};
+    passed &= checkDelta("delta.section_added", base, withShips);
+    passed &= checkDelta("delta.section_removed", withShips, base);
+    return passed;
+}
+
+bool readBytes(const std::string& path, std::vector<std::uint8_t>& bytes) {
+    std::ifstream file(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return file.good() || file.eof();
+}
+
+bool checkRestore(const std::string& name, const std::string& basePath, const std::vector<std::uint8_t>& expected,
+                  std::uint32_t expectedTurn, std::uint32_t maxTurn = std::numeric_limits<std::uint32_t>::max()) {
+    std::vector<std::uint8_t> restored;
+    std::uint32_t turn = 0;
+    if (!SaveJournal::restore(basePath, restored, turn, maxTurn)) {
+        return checkFailed(name, "nothing restored");
+    }
+    if (turn != expectedTurn) {
+        return checkFailed(name, "restored turn " + std::to_string(turn) + ", expected " + std::to_string(expectedTurn));
+    }
+    if (restored != expected) {
+        return checkFailed(name, "restored archive differs from the saved one");
+    }
+    return true;
+}
+
+bool checkSaveJournal() {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "spaceward_ho_check";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::string basePath = (directory / "autosave").string();
+
+    // Turn 0 is the checkpoint, turns 1 to 3 are journal records
+    std::vector<std::vector<std::uint8_t>> turns;
+    // Big enough that the deltas stay under half the checkpoint, so no compaction happens
+    CheckSave save = makeCheckSave(200);
+    {
+        AsyncFileWriter writer;
+        SaveJournal journal(basePath, kCheckRagged, writer);
+        for (std::uint32_t turn = 0; turn < 4; ++turn) {
+            if (turn == 2) {
+                addCheckPlanet(save, 200);
+                save.ships = {3, 4};
+            }
+            save.x[turn] += 1;
+            save.orbits[turn + 5].push_back(static_cast<std::int32_t>(turn));
+            turns.push_back(writeCheckSave(save));
+            journal.record(turn, turns.back());
+        }
+        writer.flush();
+        if (writer.getFailedWrites() > 0) {
+            return checkFailed("journal", "a write failed");
+        }
+    }
+
+    bool passed = true;
+    passed &= checkRestore("journal.latest", basePath, turns[3], 3);
+    passed &= checkRestore("journal.max_turn", basePath, turns[1], 1, 1);
+
+    std::vector<std::uint8_t> journalBytes;
+    if (!readBytes(basePath + ".journal", journalBytes) || journalBytes.size() < 8) {
+        return checkFailed("journal", "journal was not written");
+    }
+    std::vector<std::uint8_t> torn(journalBytes.begin(), journalBytes.end() - 8);
+    writeFileAtomically(basePath + ".journal", torn.data(), torn.size());
+    passed &= checkRestore("journal.torn_record", basePath, turns[2], 2);
+
+    // A newer checkpoint whose journal header was never written
+    writeFileAtomically(basePath + ".journal", journalBytes.data(), journalBytes.size());
+    writeFileAtomically(basePath + ".dat", turns[3].data(), turns[3].size());
+    passed &= checkRestore("journal.replaced_checkpoint", basePath, turns[3], 0);
+
+    std::filesystem::remove_all(directory);
+    return passed;
+}
+
+template <typename T>
+bool sameColumn(const std::vector<T>& left, const std::vector<T>& right) {
+    return left.size() == right.size() && std::memcmp(left.data(), right.data(), left.size() * sizeof(T)) == 0;
+}
+
+// integrate() must match the scalar path bit for bit, with AVX2 or without. The count
+// leaves a tail past the last group of 8, and some projectiles sit on their target.
+bool checkProjectileIntegration() {
+    RandomStream random(1, 4);
+    ProjectileStore vectorised;
+    for (int i = 0; i < 1003; ++i) {
+        float x = static_cast<float>(random.nextDouble(0.0, 1000.0));
+        float y = static_cast<float>(random.nextDouble(0.0, 1000.0));
+        vectorised.spawn(x, y, static_cast<float>(random.nextDouble(1.0, 300.0)), 1.0, PoolHandle(), PoolHandle());
+        if (i % 7 != 0) {
+            vectorised.targetX[i] = x + static_cast<float>(random.nextDouble(-20.0, 20.0));
+            vectorised.targetY[i] = y + static_cast<float>(random.nextDouble(-20.0, 20.0));
+        }
+    }
+    ProjectileStore scalar = vectorised;
+    for (int tick = 0; tick < 8; ++tick) {
+        vectorised.integrate(1.0f / 60.0f);
+        scalar.integrateScalar(1.0f / 60.0f, 0, scalar.size());
+        if (!sameColumn(vectorised.x, scalar.x) || !sameColumn(vectorised.y, scalar.y) ||
+            !sameColumn(vectorised.velocityX, scalar.velocityX) || !sameColumn(vectorised.velocityY, scalar.velocityY) ||
+            !sameColumn(vectorised.hit, scalar.hit)) {
+            return checkFailed("projectile.integrate", "vectorised and scalar results differ on tick " + std::to_string(tick));
+        }
+    }
+    return true;
+}
+
+// The incremental fog of war against a from-scratch recompute, after every batch of
+// planet, ship, range and owner changes.
+class VisibilityCheck {
+public:
+    bool run() {
+        for (int player = 0; player < 3; ++player) {
+            addPlanet();
+        }
+        visibility.setPlayerCount(3);
+        recordSeen();
+        for (int round = 0; round < 400; ++round) {
+            if (round == 200) {
+                // Every sensor is re-applied for the new player, as when a save loads
+                visibility.setPlayerCount(4);
+                recordSeen();
+            }
+            int changes = random.nextInt(1, 6);
+            for (int change = 0; change < changes; ++change) {
+                applyRandomChange();
+            }
+            visibility.update();
+            if (!compare(round)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Sensor {
+        float x;
+        float y;
+        float range;
+        int owner;
+    };
+
+    float randomCoordinate() { return static_cast<float>(random.nextDouble(0.0, 1000.0)); }
+
+    // Galaxy::addPlanet's order: the visibility system before the planet grid.
+    void addPlanet() {
+        int planetId = static_cast<int>(planets.size());
+        Sensor planet{randomCoordinate(), randomCoordinate(), 0.0f, random.nextInt(-1, 3)};
+        planets.push_back(planet);
+        visibility.addPlanet(planetId, planet.x, planet.y, planet.owner);
+        planetGrid.insert(planetId, planet.x, planet.y, -1);
+        seenPlanets.resize(planets.size() * 4, 0);
+        // addPlanet applies what was pending, which is a state players saw
+        recordSeen();
+    }
+
+    void applyRandomChange() {
+        int shipCount = static_cast<int>(ships.size());
+        switch (random.nextInt(0, 5)) {
+        case 0:
+            addPlanet();
+            break;
+        case 1: {
+            Sensor ship{randomCoordinate(), randomCoordinate(), static_cast<float>(random.nextDouble(0.0, 150.0)),
+                        random.nextInt(-1, 3)};
+            visibility.addShip(shipCount, ship.x, ship.y, ship.owner, ship.range);
+            ships.push_back(ship);
+            break;
+        }
+        case 2:
+            if (shipCount > 0) {
+                int shipId = random.nextInt(0, shipCount - 1);
+                ships[shipId].x = std::min(1000.0f, std::max(0.0f, ships[shipId].x + static_cast<float>(random.nextDouble(-80.0, 80.0))));
+                ships[shipId].y = std::min(1000.0f, std::max(0.0f, ships[shipId].y + static_cast<float>(random.nextDouble(-80.0, 80.0))));
+                visibility.moveShip(shipId, ships[shipId].x, ships[shipId].y);
+            }
+            break;
+        case 3:
+            if (shipCount > 0) {
+                int shipId = random.nextInt(0, shipCount - 1);
+                // Now and then a sensor far larger than the rest
+                ships[shipId].range = static_cast<float>(random.nextInt(0, 20) == 0 ? random.nextDouble(300.0, 600.0)
+                                                                                      : random.nextDouble(0.0, 150.0));
+                visibility.setSensorRange(shipId, ships[shipId].range);
+            }
+            break;
+        case 4:
+            if (shipCount > 0) {
+                int shipId = random.nextInt(0, shipCount - 1);
+                ships[shipId].owner = random.nextInt(-1, 3);
+                visibility.setShipOwner(shipId, ships[shipId].owner);
+            }
+            break;
+        default: {
+            int planetId = random.nextInt(0, static_cast<int>(planets.size()) - 1);
+            int owner = random.nextInt(-1, 3);
+            planets[planetId].owner = owner;
+            visibility.setPlanetOwner(planetId, owner);
+            // Owners see their planets at once, not at the next update()
+            if (owner >= 0 && owner < static_cast<int>(visibility.getPlayerCount())) {
+                seenPlanets[planetId * 4 + owner] = 1;
+            }
+            break;
+        }
+        }
+    }
+
+    bool covers(int player, float x, float y) const {
+        for (const Sensor& sensor : ships) {
+            float dx = x - sensor.x;
+            float dy = y - sensor.y;
+            if (sensor.owner == player && sensor.range > 0.0f && dx * dx + dy * dy <= sensor.range * sensor.range) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void recordSeen() {
+        for (int player = 0; player < static_cast<int>(visibility.getPlayerCount()); ++player) {
+            for (std::size_t planetId = 0; planetId < planets.size(); ++planetId) {
+                const Sensor& planet = planets[planetId];
+                if (planet.owner == player || covers(player, planet.x, planet.y)) {
+                    seenPlanets[planetId * 4 + player] = 1;
+                }
+            }
+        }
+    }
+
+    bool compare(int round) {
+        recordSeen();
+        std::string where = " after round " + std::to_string(round);
+        for (int player = 0; player < static_cast<int>(visibility.getPlayerCount()); ++player) {
+            for (std::size_t planetId = 0; planetId < planets.size(); ++planetId) {
+                const Sensor& planet = planets[planetId];
+                int id = static_cast<int>(planetId);
+                bool visible = planet.owner == player || covers(player, planet.x, planet.y);
+                if (visibility.isPlanetVisible(player, id) != visible) {
+                    return checkFailed("visibility", "planet visibility differs" + where);
+                }
+                if (visibility.hasSeenPlanet(player, id) != (seenPlanets[planetId * 4 + player] != 0)) {
+                    return checkFailed("visibility", "seen planets differ" + where);
+                }
+                if (visible && visibility.hasSeenPlanetOwnedByOther(player, id) != (planet.owner >= 0 && planet.owner != player)) {
+                    return checkFailed("visibility", "planet owner bit differs" + where);
+                }
+            }
+            for (std::size_t shipId = 0; shipId < ships.size(); ++shipId) {
+                const Sensor& ship = ships[shipId];
+                bool visible = ship.owner == player || covers(player, ship.x, ship.y);
+                if (visibility.isShipVisible(player, static_cast<int>(shipId)) != visible) {
+                    return checkFailed("visibility", "ship visibility differs" + where);
+                }
+            }
+        }
+        return true;
+    }
+
+    RandomStream random{1, 5};
+    SpatialGrid<int> planetGrid{128.0f};
+    VisibilitySystem visibility{planetGrid};
+    std::vector<Sensor> planets;
+    std::vector<Sensor> ships;
+    // Four players per planet
+    std::vector<std::uint8_t> seenPlanets;
+};
+
+bool runChecks() {
+    bool passed = checkArchiveDeltas();
+    passed &= checkProjectileIntegration();
+    passed &= VisibilityCheck().run();
+    passed &= checkSaveJournal();
+    std::cerr << (passed ? "all checks passed" : "checks failed") << std::endl;
+    return passed;
+}
+
+void printUsage() {
+    std::cout << "Usage: spaceward_ho_bench [--seed S] [--filter text] [--min-time seconds] [--out file]\n"
+                 "       spaceward_ho_bench --check" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::uint64_t seed = 1;
+    std::string filter;
+    double minSeconds = 0.5;
+    std::string outPath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--help") {
+            printUsage();
+            return 0;
+        }
+        if (option == "--check") {
+            return runChecks() ? 0 : 1;
+        }
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (option == "--seed") {
+            seed = std::strtoull(value, nullptr, 10);
+        } else if (option == "--filter") {
+            filter = value;
+        } else if (option == "--min-time") {
+            minSeconds = std::atof(value);
+        } else if (option == "--out") {
+            outPath = value;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    BenchmarkRunner runner(filter, minSeconds > 0.0 ? minSeconds : 0.5);
+    benchmarkPlanetUpdate(runner, seed);
+    benchmarkMatch(runner, seed);
+    benchmarkBattle(runner, seed);
+    benchmarkProjectiles(runner, seed);
+    benchmarkSaveLoad(runner, seed);
+
+    if (outPath.empty()) {
+        runner.writeJson(std::cout, seed);
+        return 0;
+    }
+    std::ofstream out(outPath);
+    if (!out) {
+        std::cerr << "Unable to write " << outPath << std::endl;
+        return 1;
+    }
+    runner.writeJson(out, seed);
+    return 0;
+}
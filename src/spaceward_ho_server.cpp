@@ -0,0 +1,106 @@
+// spaceward_ho_server.cpp
+// Dedicated simulation runner: plays AI-only games on the simulation core, with no
+// window, no renderer and no frame pacing, spread over every available core.
+//
+//   spaceward_ho_server [--games N] [--seed S] [--players P] [--planets K] [--turns T] [--threads W] [--profile trace.json]
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "game_logic/headless_match.h"
+#include "utility/profiler.h"
+#include "utility/worker_pool.h"
+
+namespace {
+
+void printUsage() {
+    std::cout << "Usage: spaceward_ho_server [--games N] [--seed S] [--players P] [--planets K] [--turns T] [--threads W]"
+              << " [--profile trace.json]"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int games = 1;
+    std::uint64_t seed = 1;
+    unsigned threads = std::thread::hardware_concurrency();
+    HeadlessMatch::Settings settings;
+    std::string profilePath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--help") {
+            printUsage();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (option == "--games") {
+            games = std::atoi(value);
+        } else if (option == "--seed") {
+            seed = std::strtoull(value, nullptr, 10);
+        } else if (option == "--players") {
+            settings.players = std::atoi(value);
+        } else if (option == "--planets") {
+            settings.planets = std::atoi(value);
+        } else if (option == "--turns") {
+            settings.maxTurns = std::atoi(value);
+        } else if (option == "--threads") {
+            threads = static_cast<unsigned>(std::atoi(value));
+        } else if (option == "--profile") {
+            profilePath = value;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (games < 1 || settings.players < 1 || settings.planets < 1 || settings.maxTurns < 1) {
+        printUsage();
+        return 1;
+    }
+
+    setProfileThreadName("main");
+    setProfilingEnabled(!profilePath.empty());
+
+    // Games are independent, so each is one task; game i always plays with seed + i
+    std::vector<HeadlessMatch::Result> results(games);
+    auto start = std::chrono::steady_clock::now();
+    WorkerPool pool(threads > 1 ? threads - 1 : 0);
+    pool.parallelFor(results.size(), [&](std::size_t game) {
+        ProfileZone zone("game");
+        results[game] = HeadlessMatch(settings, seed + game).run();
+    });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    setProfilingEnabled(false);
+
+    std::uint64_t steps = 0;
+    long long turns = 0;
+    for (std::size_t game = 0; game < results.size(); ++game) {
+        const HeadlessMatch::Result& result = results[game];
+        steps += result.steps;
+        turns += result.turns;
+        std::cout << "Game " << game << " (seed " << result.seed << "): ";
+        if (result.winner >= 0) {
+            std::cout << "player " << result.winner << " won";
+        } else {
+            std::cout << "no winner";
+        }
+        std::cout << " after " << result.turns << " turns, " << result.battles << " battles" << std::endl;
+    }
+    std::cout << "Played " << games << " games (" << turns << " turns, " << steps << " steps) in "
+              << elapsed.count() << " s on " << pool.getThreadCount() + 1 << " threads, "
+              << static_cast<double>(steps) / elapsed.count() << " steps/s" << std::endl;
+
+    if (!profilePath.empty() && !writeProfileTrace(profilePath)) {
+        std::cerr << "Unable to write " << profilePath << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,444 @@
+// archive_delta.cpp
+#include "archive_delta.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+enum ColumnKind : std::uint32_t {
+    RowColumn = 0,
+    RaggedCounts = 1,
+    RaggedValues = 2,
+    WholeColumn = 3
+};
+
+constexpr std::uint32_t kRowsTag = archiveTag("#ROW");
+constexpr std::uint32_t kTagsTag = archiveTag("#TAG");
+constexpr std::uint32_t kKindsTag = archiveTag("#KND");
+constexpr std::uint32_t kWidthsTag = archiveTag("#WID");
+constexpr std::uint32_t kPerTag = archiveTag("#PER");
+constexpr std::uint32_t kSectionsTag = archiveTag("#SEC");
+
+struct ColumnLayout {
+    ArchiveReader::Column column;
+    std::uint32_t kind;
+    // Elements per row for RowColumn, the partner column's tag for the ragged kinds
+    std::uint32_t per;
+};
+
+std::uint32_t readCount(const std::uint8_t* data) {
+    std::uint32_t value;
+    binary_archive::copyLittleEndian<std::uint32_t>(&value, data, 1);
+    return value;
+}
+
+const ColumnLayout* findLayout(const std::vector<ColumnLayout>& layout, std::uint32_t tag) {
+    for (const ColumnLayout& entry : layout) {
+        if (entry.column.tag == tag) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool describeSection(const ArchiveReader& reader, const ArchiveReader::Section& section,
+                     const std::vector<RaggedColumns>& ragged, std::vector<ColumnLayout>& layout) {
+    std::vector<ArchiveReader::Column> columns;
+    layout.clear();
+    if (!reader.getColumns(section, columns)) {
+        return false;
+    }
+    for (const ArchiveReader::Column& column : columns) {
+        ColumnLayout entry{column, WholeColumn, 0};
+        for (const RaggedColumns& pair : ragged) {
+            if (pair.section != section.tag) {
+                continue;
+            }
+            if (column.tag == pair.countTag && column.width == 4 && column.count == section.rowCount) {
+                entry.kind = RaggedCounts;
+                entry.per = pair.valueTag;
+            } else if (column.tag == pair.valueTag) {
+                entry.kind = RaggedValues;
+                entry.per = pair.countTag;
+            }
+        }
+        // The string table's rows are not its columns' rows: OFFS has one extra entry and
+        // CHRS holds characters, either of which can divide evenly by the string count.
+        if (entry.kind == WholeColumn && section.tag != binary_archive::kStringTableTag && section.rowCount > 0 &&
+            column.count > 0 && column.count % section.rowCount == 0) {
+            entry.kind = RowColumn;
+            entry.per = static_cast<std::uint32_t>(column.count / section.rowCount);
+        }
+        layout.push_back(entry);
+    }
+    // Half a ragged pair is compared whole
+    for (ColumnLayout& entry : layout) {
+        if (entry.kind == RaggedCounts || entry.kind == RaggedValues) {
+            const ColumnLayout* partner = findLayout(layout, entry.per);
+            std::uint32_t partnerKind = entry.kind == RaggedCounts ? RaggedValues : RaggedCounts;
+            if (partner == nullptr || (partner->kind != partnerKind && partner->kind != WholeColumn)) {
+                entry.kind = WholeColumn;
+                entry.per = 0;
+            }
+        }
+    }
+    for (ColumnLayout& entry : layout) {
+        if (entry.kind == RaggedCounts && findLayout(layout, entry.per)->kind != RaggedValues) {
+            entry.kind = WholeColumn;
+            entry.per = 0;
+        }
+    }
+    return true;
+}
+
+// Element offsets of every row of a ragged pair; false if the counts overrun the values.
+bool raggedOffsets(const ArchiveReader::Column& counts, std::uint64_t valueCount, std::vector<std::uint64_t>& offsets) {
+    offsets.assign(1, 0);
+    offsets.reserve(static_cast<std::size_t>(counts.count) + 1);
+    for (std::uint64_t row = 0; row < counts.count; ++row) {
+        offsets.push_back(offsets.back() + readCount(counts.data + row * 4));
+    }
+    return offsets.back() <= valueCount;
+}
+
+bool sameLayout(const std::vector<ColumnLayout>& current, const std::vector<ColumnLayout>& previous) {
+    if (current.size() != previous.size()) {
+        return false;
+    }
+    for (std::size_t j = 0; j < current.size(); ++j) {
+        if (current[j].column.tag != previous[j].column.tag || current[j].column.width != previous[j].column.width ||
+            current[j].kind != previous[j].kind || current[j].per != previous[j].per) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void writeTable(ArchiveWriter& writer, std::uint32_t tag, const std::vector<ColumnLayout>& layout,
+                std::uint32_t (*field)(const ColumnLayout&)) {
+    std::vector<std::uint32_t> values;
+    values.reserve(layout.size());
+    for (const ColumnLayout& entry : layout) {
+        values.push_back(field(entry));
+    }
+    writer.writeColumn(tag, values);
+}
+
+void copyColumn(ArchiveWriter& writer, const ArchiveReader::Column& column) {
+    std::size_t bytes = static_cast<std::size_t>(column.count * column.width);
+    std::uint8_t* out = writer.appendRawColumn(column.tag, column.width, static_cast<std::size_t>(column.count));
+    if (bytes > 0) {
+        std::memcpy(out, column.data, bytes);
+    }
+}
+
+bool copySection(const ArchiveReader& reader, const ArchiveReader::Section& section, ArchiveWriter& writer) {
+    std::vector<ArchiveReader::Column> columns;
+    if (!reader.getColumns(section, columns)) {
+        return false;
+    }
+    writer.beginSection(section.tag, section.rowCount);
+    for (const ArchiveReader::Column& column : columns) {
+        copyColumn(writer, column);
+    }
+    writer.endSection();
+    return true;
+}
+
+struct RaggedResult {
+    std::uint32_t valueTag;
+    std::uint32_t width;
+    std::vector<std::uint32_t> counts;
+    std::vector<std::uint8_t> values;
+};
+
+} // namespace
+
+bool encodeArchiveDelta(const ArchiveReader& previous, const ArchiveReader& current,
+                        const std::vector<RaggedColumns>& ragged, ArchiveWriter& delta) {
+    delta.clear();
+    bool anyChange = false;
+    std::vector<ColumnLayout> layout;
+    std::vector<ColumnLayout> previousLayout;
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint64_t> previousOffsets;
+    std::vector<std::uint8_t> rowChanged;
+    std::vector<std::uint8_t> wholeChanged;
+    std::vector<std::uint32_t> changedRows;
+
+    for (const ArchiveReader::Section& section : current.getSections()) {
+        if (!describeSection(current, section, ragged, layout)) {
+            continue;
+        }
+        ArchiveReader::Section previousSection;
+        bool hadSection = previous.findSection(section.tag, previousSection) &&
+                          describeSection(previous, previousSection, ragged, previousLayout);
+        std::uint32_t rows = section.rowCount;
+        std::uint32_t previousRows = hadSection ? previousSection.rowCount : 0;
+        bool comparable = hadSection && sameLayout(layout, previousLayout);
+        std::uint32_t sharedRows = comparable ? std::min(rows, previousRows) : 0;
+
+        rowChanged.assign(rows, 0);
+        std::fill(rowChanged.begin() + sharedRows, rowChanged.end(), 1);
+        wholeChanged.assign(layout.size(), comparable ? 0 : 1);
+
+        for (std::size_t j = 0; comparable && j < layout.size(); ++j) {
+            const ArchiveReader::Column& now = layout[j].column;
+            const ArchiveReader::Column& before = previousLayout[j].column;
+            if (layout[j].kind == RowColumn) {
+                std::size_t rowBytes = static_cast<std::size_t>(now.width) * layout[j].per;
+                if (std::memcmp(now.data, before.data, sharedRows * rowBytes) == 0) {
+                    continue;
+                }
+                for (std::uint32_t row = 0; row < sharedRows; ++row) {
+                    if (std::memcmp(now.data + row * rowBytes, before.data + row * rowBytes, rowBytes) != 0) {
+                        rowChanged[row] = 1;
+                    }
+                }
+            } else if (layout[j].kind == RaggedCounts) {
+                const ArchiveReader::Column& values = findLayout(layout, layout[j].per)->column;
+                const ArchiveReader::Column& previousValues = findLayout(previousLayout, layout[j].per)->column;
+                if (!raggedOffsets(now, values.count, offsets) || !raggedOffsets(before, previousValues.count, previousOffsets)) {
+                    std::fill(rowChanged.begin(), rowChanged.end(), 1);
+                    continue;
+                }
+                std::size_t width = values.width;
+                if (std::memcmp(now.data, before.data, sharedRows * 4) == 0 &&
+                    std::memcmp(values.data, previousValues.data, offsets[sharedRows] * width) == 0) {
+                    continue;
+                }
+                for (std::uint32_t row = 0; row < sharedRows; ++row) {
+                    std::uint64_t length = offsets[row + 1] - offsets[row];
+                    if (length != previousOffsets[row + 1] - previousOffsets[row] ||
+                        std::memcmp(values.data + offsets[row] * width, previousValues.data + previousOffsets[row] * width,
+                                    length * width) != 0) {
+                        rowChanged[row] = 1;
+                    }
+                }
+            } else if (layout[j].kind == WholeColumn) {
+                wholeChanged[j] = now.count != before.count ||
+                                  std::memcmp(now.data, before.data, now.count * now.width) != 0;
+            }
+        }
+
+        changedRows.clear();
+        for (std::uint32_t row = 0; row < rows; ++row) {
+            if (rowChanged[row]) {
+                changedRows.push_back(row);
+            }
+        }
+        bool sectionChanged = !hadSection || rows != previousRows || !changedRows.empty() ||
+                              std::find(wholeChanged.begin(), wholeChanged.end(), 1) != wholeChanged.end();
+        if (!sectionChanged) {
+            continue;
+        }
+        anyChange = true;
+
+        delta.beginSection(section.tag, rows);
+        delta.writeColumn(kRowsTag, changedRows);
+        writeTable(delta, kTagsTag, layout, [](const ColumnLayout& entry) { return entry.column.tag; });
+        writeTable(delta, kKindsTag, layout, [](const ColumnLayout& entry) { return entry.kind; });
+        writeTable(delta, kWidthsTag, layout, [](const ColumnLayout& entry) { return entry.column.width; });
+        writeTable(delta, kPerTag, layout, [](const ColumnLayout& entry) { return entry.per; });
+
+        for (std::size_t j = 0; j < layout.size(); ++j) {
+            const ArchiveReader::Column& column = layout[j].column;
+            if (layout[j].kind == RowColumn) {
+                std::size_t rowBytes = static_cast<std::size_t>(column.width) * layout[j].per;
+                std::uint8_t* out = delta.appendRawColumn(column.tag, column.width, changedRows.size() * layout[j].per);
+                for (std::uint32_t row : changedRows) {
+                    std::memcpy(out, column.data + row * rowBytes, rowBytes);
+                    out += rowBytes;
+                }
+            } else if (layout[j].kind == RaggedCounts) {
+                std::uint8_t* out = delta.appendRawColumn(column.tag, 4, changedRows.size());
+                for (std::uint32_t row : changedRows) {
+                    std::memcpy(out, column.data + row * 4, 4);
+                    out += 4;
+                }
+            } else if (layout[j].kind == RaggedValues) {
+                const ArchiveReader::Column& counts = findLayout(layout, layout[j].per)->column;
+                if (!raggedOffsets(counts, column.count, offsets)) {
+                    return false;
+                }
+                std::size_t total = 0;
+                for (std::uint32_t row : changedRows) {
+                    total += static_cast<std::size_t>(offsets[row + 1] - offsets[row]);
+                }
+                std::uint8_t* out = delta.appendRawColumn(column.tag, column.width, total);
+                for (std::uint32_t row : changedRows) {
+                    std::size_t bytes = static_cast<std::size_t>(offsets[row + 1] - offsets[row]) * column.width;
+                    std::memcpy(out, column.data + offsets[row] * column.width, bytes);
+                    out += bytes;
+                }
+            } else if (wholeChanged[j]) {
+                copyColumn(delta, column);
+            }
+        }
+        delta.endSection();
+    }
+
+    // Sections that were dropped or reordered change the archive even when no section's
+    // contents did.
+    std::vector<std::uint32_t> sectionTags;
+    for (const ArchiveReader::Section& section : current.getSections()) {
+        sectionTags.push_back(section.tag);
+    }
+    const std::vector<ArchiveReader::Section>& previousSections = previous.getSections();
+    anyChange = anyChange || previousSections.size() != sectionTags.size() ||
+                !std::equal(sectionTags.begin(), sectionTags.end(), previousSections.begin(),
+                            [](std::uint32_t tag, const ArchiveReader::Section& section) { return tag == section.tag; });
+    if (!anyChange) {
+        delta.clear();
+        return false;
+    }
+    delta.beginSection(kSectionsTag, static_cast<std::uint32_t>(sectionTags.size()));
+    delta.writeColumn(kTagsTag, sectionTags);
+    delta.endSection();
+    delta.finish(current.getVersion());
+    return true;
+}
+
+namespace {
+
+bool rebuildSection(const ArchiveReader& base, const ArchiveReader::Section* baseSection, const ArchiveReader& delta,
+                    const ArchiveReader::Section& deltaSection, ArchiveWriter& result) {
+    std::vector<std::uint32_t> changedRows, tags, kinds, widths, per;
+    if (!delta.readColumn(deltaSection, kRowsTag, changedRows) || !delta.readColumn(deltaSection, kTagsTag, tags) ||
+        !delta.readColumn(deltaSection, kKindsTag, kinds) || !delta.readColumn(deltaSection, kWidthsTag, widths) ||
+        !delta.readColumn(deltaSection, kPerTag, per) || kinds.size() != tags.size() ||
+        widths.size() != tags.size() || per.size() != tags.size()) {
+        return false;
+    }
+
+    std::uint32_t rows = deltaSection.rowCount;
+    std::uint32_t baseRows = baseSection != nullptr ? baseSection->rowCount : 0;
+    // Rows past the end of the base are always sent in full
+    if (rows > baseRows && rows - baseRows > changedRows.size()) {
+        return false;
+    }
+    std::vector<std::int64_t> rowSource(rows, -1);
+    for (std::size_t i = 0; i < changedRows.size(); ++i) {
+        if (changedRows[i] >= rows) {
+            return false;
+        }
+        rowSource[changedRows[i]] = static_cast<std::int64_t>(i);
+    }
+
+    auto findBase = [&](std::uint32_t tag, ArchiveReader::Column& column) {
+        return baseSection != nullptr && base.findColumn(*baseSection, tag, column);
+    };
+
+    // Ragged pairs are rebuilt up front, since their two columns depend on each other.
+    std::vector<RaggedResult> raggedResults;
+    std::vector<std::uint64_t> deltaOffsets;
+    std::vector<std::uint64_t> baseOffsets;
+    for (std::size_t j = 0; j < tags.size(); ++j) {
+        if (kinds[j] != RaggedCounts) {
+            continue;
+        }
+        std::size_t partner = std::find(tags.begin(), tags.end(), per[j]) - tags.begin();
+        if (partner == tags.size() || kinds[partner] != RaggedValues) {
+            return false;
+        }
+        RaggedResult ragged{per[j], widths[partner], {}, {}};
+        ArchiveReader::Column deltaCounts, deltaValues, baseCounts, baseValues;
+        if (!delta.findColumn(deltaSection, tags[j], deltaCounts) || deltaCounts.width != 4 ||
+            deltaCounts.count != changedRows.size() || !delta.findColumn(deltaSection, per[j], deltaValues) ||
+            deltaValues.width != ragged.width || !raggedOffsets(deltaCounts, deltaValues.count, deltaOffsets)) {
+            return false;
+        }
+        bool baseUsable = findBase(tags[j], baseCounts) && baseCounts.width == 4 && baseCounts.count == baseRows &&
+                          findBase(per[j], baseValues) && baseValues.width == ragged.width &&
+                          raggedOffsets(baseCounts, baseValues.count, baseOffsets);
+
+        ragged.counts.resize(rows, 0);
+        for (std::uint32_t row = 0; row < rows; ++row) {
+            const std::uint8_t* source = nullptr;
+            std::uint64_t length = 0;
+            if (rowSource[row] >= 0) {
+                std::size_t i = static_cast<std::size_t>(rowSource[row]);
+                length = deltaOffsets[i + 1] - deltaOffsets[i];
+                source = deltaValues.data + deltaOffsets[i] * ragged.width;
+            } else if (baseUsable && row < baseRows) {
+                length = baseOffsets[row + 1] - baseOffsets[row];
+                source = baseValues.data + baseOffsets[row] * ragged.width;
+            }
+            ragged.counts[row] = static_cast<std::uint32_t>(length);
+            ragged.values.insert(ragged.values.end(), source, source + length * ragged.width);
+        }
+        raggedResults.push_back(std::move(ragged));
+    }
+
+    result.beginSection(deltaSection.tag, rows);
+    for (std::size_t j = 0; j < tags.size(); ++j) {
+        ArchiveReader::Column deltaColumn, baseColumn;
+        bool inDelta = delta.findColumn(deltaSection, tags[j], deltaColumn);
+        if (kinds[j] == RowColumn) {
+            std::size_t rowBytes = static_cast<std::size_t>(widths[j]) * per[j];
+            if (!inDelta || deltaColumn.width != widths[j] || deltaColumn.count != changedRows.size() * per[j]) {
+                return false;
+            }
+            bool baseUsable = findBase(tags[j], baseColumn) && baseColumn.width == widths[j] &&
+                              baseColumn.count == static_cast<std::uint64_t>(baseRows) * per[j];
+            if (static_cast<std::uint64_t>(rows) * per[j] > (baseUsable ? baseColumn.count : 0) + deltaColumn.count) {
+                return false;
+            }
+            std::uint8_t* out = result.appendRawColumn(tags[j], widths[j], static_cast<std::size_t>(rows) * per[j]);
+            for (std::uint32_t row = 0; row < rows; ++row, out += rowBytes) {
+                if (rowSource[row] >= 0) {
+                    std::memcpy(out, deltaColumn.data + rowSource[row] * rowBytes, rowBytes);
+                } else if (baseUsable && row < baseRows) {
+                    std::memcpy(out, baseColumn.data + row * rowBytes, rowBytes);
+                }
+            }
+        } else if (kinds[j] == RaggedCounts || kinds[j] == RaggedValues) {
+            std::uint32_t valueTag = kinds[j] == RaggedCounts ? per[j] : tags[j];
+            auto ragged = std::find_if(raggedResults.begin(), raggedResults.end(),
+                                       [valueTag](const RaggedResult& entry) { return entry.valueTag == valueTag; });
+            if (ragged == raggedResults.end()) {
+                return false;
+            }
+            if (kinds[j] == RaggedCounts) {
+                result.writeColumn(tags[j], ragged->counts);
+            } else {
+                std::size_t count = ragged->values.size() / ragged->width;
+                std::uint8_t* out = result.appendRawColumn(tags[j], ragged->width, count);
+                if (!ragged->values.empty()) {
+                    std::memcpy(out, ragged->values.data(), ragged->values.size());
+                }
+            }
+        } else if (inDelta) {
+            copyColumn(result, deltaColumn);
+        } else if (findBase(tags[j], baseColumn)) {
+            copyColumn(result, baseColumn);
+        }
+    }
+    result.endSection();
+    return true;
+}
+
+} // namespace
+
+bool applyArchiveDelta(const ArchiveReader& base, const ArchiveReader& delta, ArchiveWriter& result) {
+    result.clear();
+    ArchiveReader::Section order;
+    std::vector<std::uint32_t> sectionTags;
+    if (!delta.findSection(kSectionsTag, order) || !delta.readColumn(order, kTagsTag, sectionTags)) {
+        return false;
+    }
+    ArchiveReader::Section baseSection;
+    ArchiveReader::Section deltaSection;
+    for (std::uint32_t tag : sectionTags) {
+        bool inBase = base.findSection(tag, baseSection);
+        bool rebuilt = delta.findSection(tag, deltaSection)
+                           ? rebuildSection(base, inBase ? &baseSection : nullptr, delta, deltaSection, result)
+                           : inBase && copySection(base, baseSection, result);
+        if (!rebuilt) {
+            return false;
+        }
+    }
+    result.finish(delta.getVersion());
+    return true;
+}
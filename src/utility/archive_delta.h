@@ -0,0 +1,40 @@
+// archive_delta.h
+#ifndef ARCHIVE_DELTA_H
+#define ARCHIVE_DELTA_H
+
+#include <cstdint>
+#include <vector>
+#include "binary_archive.h"
+
+// Row-level differences between two binary archives.
+//
+// A column whose element count is a multiple of its section's row count is split into
+// rows (k elements each); columns named in a RaggedColumns pair are split by their
+// per-row counts; anything else is compared whole. A row counts as changed when any
+// of its columns differ, and the delta holds every row-shaped column for exactly those
+// rows, plus the whole columns that differ. Sections that did not change are left out.
+//
+// Each delta section has the current row count and these bookkeeping columns:
+//   "#ROW"  changed row ids
+//   "#TAG"  every column of the current section, in order
+//   "#KND"  kind of each: 0 rows, 1 ragged counts, 2 ragged values, 3 whole
+//   "#WID"  element width of each
+//   "#PER"  elements per row for kind 0; the partner column's tag for kinds 1 and 2
+// A last section "#SEC" lists every section of the current archive in order (column
+// "#TAG"), so sections that were added, dropped or moved come back where they were.
+struct RaggedColumns {
+    std::uint32_t section;
+    std::uint32_t countTag;
+    std::uint32_t valueTag;
+};
+
+// Writes the delta from previous to current into delta (cleared first). Returns false
+// when nothing changed, in which case delta is left empty.
+bool encodeArchiveDelta(const ArchiveReader& previous, const ArchiveReader& current,
+                        const std::vector<RaggedColumns>& ragged, ArchiveWriter& delta);
+
+// Rebuilds the current archive from the previous one and a delta into result (cleared
+// first), byte for byte. False if the delta does not fit the base.
+bool applyArchiveDelta(const ArchiveReader& base, const ArchiveReader& delta, ArchiveWriter& result);
+
+#endif
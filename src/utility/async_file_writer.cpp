@@ -0,0 +1,127 @@
+// async_file_writer.cpp
+#include "async_file_writer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+bool writeFileAtomically(const std::string& path, const std::uint8_t* data, std::size_t size) {
+    std::string temporaryPath = path + ".tmp";
+    std::FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool written = std::fwrite(data, 1, size, file) == size && std::fflush(file) == 0;
+#if defined(__unix__) || defined(__APPLE__)
+    // The rename must not reach the disk before the data does
+    written = written && ::fsync(::fileno(file)) == 0;
+#endif
+    written = std::fclose(file) == 0 && written;
+    if (!written) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+#if defined(_WIN32)
+    bool renamed = MoveFileExA(temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    bool renamed = std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+#endif
+    if (!renamed) {
+        std::remove(temporaryPath.c_str());
+    }
+    return renamed;
+}
+
+bool appendFileDurably(const std::string& path, const std::uint8_t* data, std::size_t size) {
+    std::FILE* file = std::fopen(path.c_str(), "ab");
+    if (file == nullptr) {
+        return false;
+    }
+    bool written = std::fwrite(data, 1, size, file) == size && std::fflush(file) == 0;
+#if defined(__unix__) || defined(__APPLE__)
+    written = written && ::fsync(::fileno(file)) == 0;
+#endif
+    return std::fclose(file) == 0 && written;
+}
+
+AsyncFileWriter::AsyncFileWriter() : worker(&AsyncFileWriter::writerLoop, this) {}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+void AsyncFileWriter::submit(const std::string& path, const std::uint8_t* data, std::size_t size) {
+    enqueue(path, data, size, false);
+}
+
+void AsyncFileWriter::append(const std::string& path, const std::uint8_t* data, std::size_t size) {
+    enqueue(path, data, size, true);
+}
+
+void AsyncFileWriter::enqueue(const std::string& path, const std::uint8_t* data, std::size_t size, bool append) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto last = std::find_if(queue.rbegin(), queue.rend(), [&path](const Job& job) { return job.path == path; });
+        std::vector<Job>::iterator pending = queue.end();
+        if (!append && last != queue.rend() && !last->append) {
+            pending = std::prev(last.base());
+        } else {
+            queue.push_back(Job{path, std::vector<std::uint8_t>(), append});
+            pending = queue.end() - 1;
+            if (!spareBuffers.empty()) {
+                pending->bytes.swap(spareBuffers.back());
+                spareBuffers.pop_back();
+            }
+        }
+        pending->bytes.assign(data, data + size);
+    }
+    wake.notify_one();
+}
+
+void AsyncFileWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return queue.empty() && !writing; });
+}
+
+void AsyncFileWriter::writerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                // Only reached when stopping with nothing left to write
+                return;
+            }
+            job = std::move(queue.front());
+            queue.erase(queue.begin());
+            writing = true;
+        }
+
+        bool written = job.append ? appendFileDurably(job.path, job.bytes.data(), job.bytes.size())
+                                  : writeFileAtomically(job.path, job.bytes.data(), job.bytes.size());
+        if (written) {
+            ++completedWrites;
+        } else {
+            ++failedWrites;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            writing = false;
+            spareBuffers.push_back(std::move(job.bytes));
+        }
+        idle.notify_all();
+    }
+}
@@ -0,0 +1,66 @@
+// async_file_writer.h
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes to path + ".tmp", flushes it to disk and renames it over path, so readers
+// only ever see the old file or the complete new one.
+bool writeFileAtomically(const std::string& path, const std::uint8_t* data, std::size_t size);
+
+// Appends to path and flushes it to disk before returning.
+bool appendFileDurably(const std::string& path, const std::uint8_t* data, std::size_t size);
+
+// One background thread that writes whole files with writeFileAtomically() and
+// appends with appendFileDurably(), in submission order. submit() copies the bytes and
+// returns; when the last job queued for the same path is also a whole-file write it is
+// replaced, so a slow disk only ever falls behind by one file per path.
+class AsyncFileWriter {
+public:
+    AsyncFileWriter();
+    // Finishes every queued write before returning.
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    void submit(const std::string& path, const std::uint8_t* data, std::size_t size);
+    void append(const std::string& path, const std::uint8_t* data, std::size_t size);
+
+    // Blocks until every write submitted so far is on disk (or has failed).
+    void flush();
+
+    std::size_t getCompletedWrites() const { return completedWrites.load(); }
+    std::size_t getFailedWrites() const { return failedWrites.load(); }
+
+private:
+    struct Job {
+        std::string path;
+        std::vector<std::uint8_t> bytes;
+        bool append = false;
+    };
+
+    void enqueue(const std::string& path, const std::uint8_t* data, std::size_t size, bool append);
+    void writerLoop();
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::vector<Job> queue;
+    // Buffers of finished jobs, kept so steady-state submits do not allocate
+    std::vector<std::vector<std::uint8_t>> spareBuffers;
+    bool writing = false;
+    bool stopping = false;
+    std::atomic<std::size_t> completedWrites{0};
+    std::atomic<std::size_t> failedWrites{0};
+    std::thread worker;
+};
+
+#endif
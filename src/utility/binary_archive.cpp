@@ -0,0 +1,242 @@
+// binary_archive.cpp
+#include "binary_archive.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace {
+
+template <typename T>
+T readValue(const std::uint8_t* data) {
+    T value;
+    binary_archive::copyLittleEndian<T>(&value, data, 1);
+    return value;
+}
+
+std::size_t paddedSize(std::uint64_t size) {
+    return static_cast<std::size_t>((size + 7) & ~std::uint64_t(7));
+}
+
+} // namespace
+
+void ArchiveWriter::clear() {
+    buffer.clear();
+    sections.clear();
+    stringOffsets.clear();
+    stringBytes.clear();
+    stringIds.clear();
+    inSection = false;
+    // Header is patched by finish()
+    buffer.resize(binary_archive::kHeaderSize, 0);
+}
+
+void ArchiveWriter::beginSection(std::uint32_t tag, std::uint32_t rowCount) {
+    if (buffer.empty()) {
+        clear();
+    }
+    if (inSection) {
+        endSection();
+    }
+    sections.push_back(SectionEntry{tag, rowCount, buffer.size(), 0});
+    inSection = true;
+}
+
+void ArchiveWriter::endSection() {
+    if (inSection) {
+        sections.back().size = buffer.size() - sections.back().offset;
+        inSection = false;
+    }
+}
+
+std::uint32_t ArchiveWriter::addString(const std::string& text) {
+    // Strings may come before the first section, which would otherwise clear them
+    if (buffer.empty()) {
+        clear();
+    }
+    auto found = stringIds.find(text);
+    if (found != stringIds.end()) {
+        return found->second;
+    }
+    std::uint32_t id = static_cast<std::uint32_t>(stringOffsets.size());
+    stringOffsets.push_back(static_cast<std::uint32_t>(stringBytes.size()));
+    stringBytes.insert(stringBytes.end(), text.begin(), text.end());
+    stringIds.emplace(text, id);
+    return id;
+}
+
+const std::vector<std::uint8_t>& ArchiveWriter::finish(std::uint32_t version) {
+    if (buffer.empty()) {
+        clear();
+    }
+    endSection();
+
+    if (!stringOffsets.empty()) {
+        std::uint32_t stringCount = static_cast<std::uint32_t>(stringOffsets.size());
+        stringOffsets.push_back(static_cast<std::uint32_t>(stringBytes.size()));
+        beginSection(binary_archive::kStringTableTag, stringCount);
+        writeColumn(archiveTag("OFFS"), stringOffsets);
+        writeColumn(archiveTag("CHRS"), stringBytes);
+        endSection();
+        stringOffsets.pop_back();
+    }
+
+    std::uint64_t tableOffset = buffer.size();
+    for (const SectionEntry& section : sections) {
+        append(section.tag);
+        append(section.rowCount);
+        append(section.offset);
+        append(section.size);
+    }
+
+    std::memcpy(&buffer[0], binary_archive::kMagic, 4);
+    binary_archive::copyLittleEndian<std::uint32_t>(&buffer[4], &version, 1);
+    std::uint32_t sectionCount = static_cast<std::uint32_t>(sections.size());
+    binary_archive::copyLittleEndian<std::uint32_t>(&buffer[8], &sectionCount, 1);
+    std::uint32_t reserved = 0;
+    binary_archive::copyLittleEndian<std::uint32_t>(&buffer[12], &reserved, 1);
+    binary_archive::copyLittleEndian<std::uint64_t>(&buffer[16], &tableOffset, 1);
+    return buffer;
+}
+
+void ArchiveWriter::writeColumnHeader(std::uint32_t tag, std::uint32_t width, std::size_t count) {
+    append(tag);
+    append(width);
+    append(static_cast<std::uint64_t>(count));
+}
+
+std::uint8_t* ArchiveWriter::appendRawColumn(std::uint32_t tag, std::uint32_t width, std::size_t count) {
+    writeColumnHeader(tag, width, count);
+    std::size_t at = buffer.size();
+    buffer.resize(paddedSize(at + count * width), 0);
+    return buffer.data() + at;
+}
+
+bool ArchiveReader::readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    std::streamoff length = file.tellg();
+    if (length < 0) {
+        return false;
+    }
+    file.seekg(0, std::ios::beg);
+    fileBuffer.resize(static_cast<std::size_t>(length));
+    if (length > 0 && !file.read(reinterpret_cast<char*>(fileBuffer.data()), length)) {
+        return false;
+    }
+    return open(fileBuffer.data(), fileBuffer.size());
+}
+
+bool ArchiveReader::hasMagic(const std::uint8_t* data, std::size_t size) {
+    return size >= 4 && std::memcmp(data, binary_archive::kMagic, 4) == 0;
+}
+
+bool ArchiveReader::open(const std::uint8_t* data, std::size_t size) {
+    sections.clear();
+    strings.clear();
+    if (size < binary_archive::kHeaderSize || !hasMagic(data, size)) {
+        return false;
+    }
+    version = readValue<std::uint32_t>(data + 4);
+    std::uint32_t sectionCount = readValue<std::uint32_t>(data + 8);
+    std::uint64_t tableOffset = readValue<std::uint64_t>(data + 16);
+    if (tableOffset > size || (size - tableOffset) / binary_archive::kSectionEntrySize < sectionCount) {
+        return false;
+    }
+
+    sections.reserve(sectionCount);
+    const std::uint8_t* entry = data + tableOffset;
+    for (std::uint32_t i = 0; i < sectionCount; ++i, entry += binary_archive::kSectionEntrySize) {
+        Section section;
+        section.tag = readValue<std::uint32_t>(entry);
+        section.rowCount = readValue<std::uint32_t>(entry + 4);
+        std::uint64_t offset = readValue<std::uint64_t>(entry + 8);
+        section.size = readValue<std::uint64_t>(entry + 16);
+        if (offset > size || section.size > size - offset) {
+            return false;
+        }
+        section.data = data + offset;
+        sections.push_back(section);
+    }
+    return loadStringTable();
+}
+
+bool ArchiveReader::findSection(std::uint32_t tag, Section& section) const {
+    for (const Section& candidate : sections) {
+        if (candidate.tag == tag) {
+            section = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ArchiveReader::findColumn(const Section& section, std::uint32_t tag, Column& column) const {
+    std::uint64_t at = 0;
+    while (nextColumn(section, at, column)) {
+        if (column.tag == tag) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ArchiveReader::getColumns(const Section& section, std::vector<Column>& columns) const {
+    columns.clear();
+    std::uint64_t at = 0;
+    Column column;
+    while (nextColumn(section, at, column)) {
+        columns.push_back(column);
+    }
+    // Anything left over is a truncated column
+    return at == section.size;
+}
+
+bool ArchiveReader::nextColumn(const Section& section, std::uint64_t& at, Column& column) const {
+    if (section.size - at < binary_archive::kColumnHeaderSize) {
+        return false;
+    }
+    const std::uint8_t* header = section.data + at;
+    std::uint32_t width = readValue<std::uint32_t>(header + 4);
+    std::uint64_t count = readValue<std::uint64_t>(header + 8);
+    std::uint64_t dataAt = at + binary_archive::kColumnHeaderSize;
+    if (width == 0 || count > (section.size - dataAt) / width) {
+        return false;
+    }
+    column.tag = readValue<std::uint32_t>(header);
+    column.width = width;
+    column.count = count;
+    column.data = section.data + dataAt;
+    at = dataAt + std::min<std::uint64_t>(paddedSize(count * width), section.size - dataAt);
+    return true;
+}
+
+const std::string& ArchiveReader::getString(std::uint32_t id) const {
+    return id < strings.size() ? strings[id] : emptyString;
+}
+
+bool ArchiveReader::loadStringTable() {
+    Section table;
+    if (!findSection(binary_archive::kStringTableTag, table)) {
+        return true;
+    }
+    std::vector<std::uint32_t> offsets;
+    std::vector<char> bytes;
+    // A delta archive's "STRS" section only carries what changed; it has no table of its own.
+    if (!readColumn(table, archiveTag("OFFS"), offsets) || !readColumn(table, archiveTag("CHRS"), bytes)) {
+        return true;
+    }
+    if (offsets.empty()) {
+        return false;
+    }
+    strings.reserve(offsets.size() - 1);
+    for (std::size_t i = 0; i + 1 < offsets.size(); ++i) {
+        if (offsets[i] > offsets[i + 1] || offsets[i + 1] > bytes.size()) {
+            return false;
+        }
+        strings.emplace_back(bytes.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    return true;
+}
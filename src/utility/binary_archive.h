@@ -0,0 +1,183 @@
+// binary_archive.h
+#ifndef BINARY_ARCHIVE_H
+#define BINARY_ARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Versioned binary container made of tagged sections of tagged columns.
+//
+//   header         magic "SWHO", format version, section count, reserved, section table offset
+//   sections       per column: tag, element width, element count, then the values
+//   string table   section "STRS": "OFFS" (count + 1 offsets) and "CHRS" (the bytes)
+//   section table  per section: tag, row count, offset, size
+//
+// Every value is fixed-width little-endian and every column starts on an 8-byte
+// boundary. Columns are found by tag, so readers skip columns and sections they do
+// not know, and columns missing from older files are left at their defaults.
+constexpr std::uint32_t archiveTag(const char (&name)[5]) {
+    return static_cast<std::uint32_t>(static_cast<unsigned char>(name[0])) |
+           static_cast<std::uint32_t>(static_cast<unsigned char>(name[1])) << 8 |
+           static_cast<std::uint32_t>(static_cast<unsigned char>(name[2])) << 16 |
+           static_cast<std::uint32_t>(static_cast<unsigned char>(name[3])) << 24;
+}
+
+namespace binary_archive {
+
+constexpr char kMagic[4] = {'S', 'W', 'H', 'O'};
+constexpr std::size_t kHeaderSize = 24;
+constexpr std::size_t kSectionEntrySize = 24;
+constexpr std::size_t kColumnHeaderSize = 16;
+constexpr std::uint32_t kStringTableTag = archiveTag("STRS");
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool kHostLittleEndian = false;
+#else
+constexpr bool kHostLittleEndian = true;
+#endif
+
+// Copies count values of T between host order and little-endian bytes.
+template <typename T>
+void copyLittleEndian(void* destination, const void* source, std::size_t count) {
+    if (kHostLittleEndian || sizeof(T) == 1) {
+        std::memcpy(destination, source, count * sizeof(T));
+        return;
+    }
+    unsigned char* out = static_cast<unsigned char*>(destination);
+    const unsigned char* in = static_cast<const unsigned char*>(source);
+    for (std::size_t i = 0; i < count; ++i, out += sizeof(T), in += sizeof(T)) {
+        for (std::size_t byte = 0; byte < sizeof(T); ++byte) {
+            out[byte] = in[sizeof(T) - 1 - byte];
+        }
+    }
+}
+
+} // namespace binary_archive
+
+class ArchiveWriter {
+public:
+    // Starts a new archive; the buffer keeps its capacity, so repeated saves do not reallocate.
+    void clear();
+
+    void beginSection(std::uint32_t tag, std::uint32_t rowCount);
+    void endSection();
+
+    template <typename T>
+    void writeColumn(std::uint32_t tag, const T* values, std::size_t count) {
+        static_assert(std::is_arithmetic<T>::value, "columns hold plain numbers");
+        std::uint8_t* out = appendRawColumn(tag, sizeof(T), count);
+        if (count > 0) {
+            binary_archive::copyLittleEndian<T>(out, values, count);
+        }
+    }
+
+    template <typename T>
+    void writeColumn(std::uint32_t tag, const std::vector<T>& values) {
+        writeColumn(tag, values.data(), values.size());
+    }
+
+    // Reserves a column of count elements of width bytes and returns where its
+    // little-endian bytes go. The pointer is only valid until the next write.
+    std::uint8_t* appendRawColumn(std::uint32_t tag, std::uint32_t width, std::size_t count);
+
+    // Index into the string table; equal strings share one entry.
+    std::uint32_t addString(const std::string& text);
+
+    // Appends the string table (when addString was used) and the section table, and
+    // patches the header. Archives rebuilt from other archives can carry their string
+    // table as an ordinary "STRS" section instead.
+    const std::vector<std::uint8_t>& finish(std::uint32_t version);
+
+    const std::vector<std::uint8_t>& getBuffer() const { return buffer; }
+
+private:
+    struct SectionEntry {
+        std::uint32_t tag;
+        std::uint32_t rowCount;
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    template <typename T>
+    void append(T value) {
+        std::size_t at = buffer.size();
+        buffer.resize(at + sizeof(T));
+        binary_archive::copyLittleEndian<T>(&buffer[at], &value, 1);
+    }
+
+    void writeColumnHeader(std::uint32_t tag, std::uint32_t width, std::size_t count);
+
+    std::vector<std::uint8_t> buffer;
+    std::vector<SectionEntry> sections;
+    std::vector<std::uint32_t> stringOffsets;
+    std::vector<char> stringBytes;
+    std::unordered_map<std::string, std::uint32_t> stringIds;
+    bool inSection = false;
+};
+
+class ArchiveReader {
+public:
+    struct Column {
+        std::uint32_t tag = 0;
+        std::uint32_t width = 0;
+        std::uint64_t count = 0;
+        const std::uint8_t* data = nullptr;
+    };
+
+    struct Section {
+        std::uint32_t tag = 0;
+        std::uint32_t rowCount = 0;
+        const std::uint8_t* data = nullptr;
+        std::uint64_t size = 0;
+    };
+
+    // Both return false on anything malformed: bad magic, truncation, out-of-range offsets.
+    bool readFile(const std::string& path);
+    bool open(const std::uint8_t* data, std::size_t size);
+
+    // True when the bytes start with the archive magic, so callers can fall back to other formats.
+    static bool hasMagic(const std::uint8_t* data, std::size_t size);
+
+    std::uint32_t getVersion() const { return version; }
+    const std::vector<Section>& getSections() const { return sections; }
+    bool findSection(std::uint32_t tag, Section& section) const;
+    bool findColumn(const Section& section, std::uint32_t tag, Column& column) const;
+    // Every column of the section in file order; false if the section is malformed.
+    bool getColumns(const Section& section, std::vector<Column>& columns) const;
+
+    // False when the column is missing or its element width is not sizeof(T); out is left as it was.
+    template <typename T>
+    bool readColumn(const Section& section, std::uint32_t tag, std::vector<T>& out) const {
+        static_assert(std::is_arithmetic<T>::value, "columns hold plain numbers");
+        Column column;
+        if (!findColumn(section, tag, column) || column.width != sizeof(T)) {
+            return false;
+        }
+        out.resize(static_cast<std::size_t>(column.count));
+        if (column.count > 0) {
+            binary_archive::copyLittleEndian<T>(out.data(), column.data, out.size());
+        }
+        return true;
+    }
+
+    // Empty string for ids past the end of the table.
+    const std::string& getString(std::uint32_t id) const;
+
+private:
+    // Reads the column starting at `at` and moves `at` past it; false at the end or on a bad header.
+    bool nextColumn(const Section& section, std::uint64_t& at, Column& column) const;
+    bool loadStringTable();
+
+    std::vector<std::uint8_t> fileBuffer;
+    std::uint32_t version = 0;
+    std::vector<Section> sections;
+    std::vector<std::string> strings;
+    std::string emptyString;
+};
+
+#endif
@@ -0,0 +1,76 @@
+// frame_arena.cpp
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace {
+
+std::atomic<std::uint64_t> frameGeneration{0};
+
+} // namespace
+
+FrameArena::FrameArena(std::size_t blockSize) : blockSize(std::max<std::size_t>(blockSize, 256)) {}
+
+void FrameArena::reset() {
+    if (blocks.size() > 1) {
+        std::size_t total = getCapacity();
+        blocks.clear();
+        addBlock(total);
+    }
+    currentBlock = 0;
+    offset = 0;
+    bytesAllocated = 0;
+}
+
+std::size_t FrameArena::getCapacity() const {
+    std::size_t total = 0;
+    for (const Block& block : blocks) {
+        total += block.size;
+    }
+    return total;
+}
+
+void FrameArena::addBlock(std::size_t size) {
+    blocks.push_back(Block{std::unique_ptr<std::byte[]>(new std::byte[size]), size});
+}
+
+void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    for (;;) {
+        if (currentBlock < blocks.size()) {
+            Block& block = blocks[currentBlock];
+            std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.memory.get());
+            std::size_t aligned = static_cast<std::size_t>(((base + offset + alignment - 1) & ~(alignment - 1)) - base);
+            if (aligned <= block.size && bytes <= block.size - aligned) {
+                offset = aligned + bytes;
+                bytesAllocated += bytes;
+                return block.memory.get() + aligned;
+            }
+            // The rest of this block stays unused until reset()
+            if (currentBlock + 1 < blocks.size()) {
+                ++currentBlock;
+                offset = 0;
+                continue;
+            }
+        }
+        addBlock(std::max(blockSize, bytes + alignment));
+        currentBlock = blocks.size() - 1;
+        offset = 0;
+    }
+}
+
+FrameArena& frameArena() {
+    thread_local FrameArena arena;
+    thread_local std::uint64_t generation = 0;
+    std::uint64_t current = frameGeneration.load(std::memory_order_acquire);
+    if (generation != current) {
+        arena.reset();
+        generation = current;
+    }
+    return arena;
+}
+
+void releaseFrameArenas() {
+    frameGeneration.fetch_add(1, std::memory_order_release);
+}
@@ -0,0 +1,55 @@
+// frame_arena.h
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Bump allocator for data that only lives for one simulation tick, usable by any
+// std::pmr container. Deallocation does nothing; reset() makes the whole arena
+// available again. Once the arena has grown to a tick's peak it no longer allocates.
+class FrameArena : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(std::size_t blockSize = 64 * 1024);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Everything allocated so far becomes invalid. If the last tick spilled into more
+    // than one block they are merged into one, so the next tick fits in a single block.
+    void reset();
+
+    std::size_t getBytesAllocated() const { return bytesAllocated; }
+    std::size_t getCapacity() const;
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        std::size_t size;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void addBlock(std::size_t size);
+
+    std::vector<Block> blocks;
+    std::size_t blockSize;
+    std::size_t currentBlock = 0;
+    std::size_t offset = 0;
+    std::size_t bytesAllocated = 0;
+};
+
+// The calling thread's arena for the current tick. Containers built on it must not
+// outlive the tick: after releaseFrameArenas(), each thread's arena is reset the next
+// time that thread asks for it.
+FrameArena& frameArena();
+
+// Ends the tick for every thread's arena. Call on the game thread once the tick's
+// parallel work has finished.
+void releaseFrameArenas();
+
+#endif
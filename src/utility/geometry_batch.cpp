@@ -0,0 +1,230 @@
+// geometry_batch.cpp
+#include "geometry_batch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if GEOMETRY_BATCH_RENDER_GEOMETRY
+
+void GeometryBatch::clear() {
+    vertices.clear();
+    indices.clear();
+}
+
+bool GeometryBatch::empty() const {
+    return indices.empty();
+}
+
+void GeometryBatch::addVertex(float x, float y, SDL_Color color) {
+    SDL_Vertex vertex;
+    vertex.position = {x, y};
+    vertex.color = color;
+    vertex.tex_coord = {0.0f, 0.0f};
+    vertices.push_back(vertex);
+}
+
+// Geometry has no point primitive; a point is a one-pixel quad
+void GeometryBatch::addPoint(float x, float y, SDL_Color color) {
+    addRect({x, y, 1.0f, 1.0f}, color);
+}
+
+void GeometryBatch::addRect(const SDL_FRect& rect, SDL_Color color) {
+    int first = static_cast<int>(vertices.size());
+    addVertex(rect.x, rect.y, color);
+    addVertex(rect.x + rect.w, rect.y, color);
+    addVertex(rect.x + rect.w, rect.y + rect.h, color);
+    addVertex(rect.x, rect.y + rect.h, color);
+    const int quad[6] = {0, 1, 2, 0, 2, 3};
+    for (int corner : quad) {
+        indices.push_back(first + corner);
+    }
+}
+
+void GeometryBatch::addTriangle(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_Color color) {
+    int first = static_cast<int>(vertices.size());
+    addVertex(a.x, a.y, color);
+    addVertex(b.x, b.y, color);
+    addVertex(c.x, c.y, color);
+    indices.push_back(first);
+    indices.push_back(first + 1);
+    indices.push_back(first + 2);
+}
+
+// A fan around the centre, with more segments for larger circles
+void GeometryBatch::addCircle(float x, float y, float radius, SDL_Color color) {
+    int segments = std::max(8, std::min(64, static_cast<int>(radius) + 8));
+    int center = static_cast<int>(vertices.size());
+    addVertex(x, y, color);
+    for (int i = 0; i < segments; ++i) {
+        float angle = 2.0f * static_cast<float>(M_PI) * i / segments;
+        addVertex(x + radius * std::cos(angle), y + radius * std::sin(angle), color);
+    }
+    for (int i = 0; i < segments; ++i) {
+        indices.push_back(center);
+        indices.push_back(center + 1 + i);
+        indices.push_back(center + 1 + (i + 1) % segments);
+    }
+}
+
+void GeometryBatch::draw(SDL_Renderer* renderer) const {
+    if (indices.empty()) {
+        return;
+    }
+    SDL_RenderGeometry(renderer, nullptr, vertices.data(), static_cast<int>(vertices.size()),
+                       indices.data(), static_cast<int>(indices.size()));
+}
+
+#else
+
+namespace {
+
+bool sameColor(SDL_Color a, SDL_Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+} // namespace
+
+void GeometryBatch::clear() {
+    runs.clear();
+    points.clear();
+    spans.clear();
+}
+
+bool GeometryBatch::empty() const {
+    return runs.empty();
+}
+
+void GeometryBatch::extendRun(SDL_Color color, bool isPoints, std::size_t first, std::size_t count) {
+    if (count == 0) {
+        return;
+    }
+    if (!runs.empty() && runs.back().points == isPoints && sameColor(runs.back().color, color) &&
+        runs.back().first + runs.back().count == first) {
+        runs.back().count += count;
+        return;
+    }
+    runs.push_back({color, isPoints, first, count});
+}
+
+void GeometryBatch::addSpan(float left, float right, float top, SDL_Color color) {
+    if (right <= left) {
+        return;
+    }
+    std::size_t first = spans.size();
+    spans.push_back({left, top, right - left, 1.0f});
+    extendRun(color, false, first, 1);
+}
+
+void GeometryBatch::addPoint(float x, float y, SDL_Color color) {
+    std::size_t first = points.size();
+    points.push_back({x, y});
+    extendRun(color, true, first, 1);
+}
+
+void GeometryBatch::addRect(const SDL_FRect& rect, SDL_Color color) {
+    std::size_t first = spans.size();
+    spans.push_back(rect);
+    extendRun(color, false, first, 1);
+}
+
+// Filled one pixel row at a time, sampling each row at its centre
+void GeometryBatch::addTriangle(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_Color color) {
+    const SDL_FPoint corners[3] = {a, b, c};
+    float top = std::floor(std::min({a.y, b.y, c.y}));
+    float bottom = std::ceil(std::max({a.y, b.y, c.y}));
+    for (float row = top; row < bottom; row += 1.0f) {
+        float sample = row + 0.5f;
+        float left = 0.0f;
+        float right = 0.0f;
+        int crossings = 0;
+        for (int i = 0; i < 3; ++i) {
+            SDL_FPoint from = corners[i];
+            SDL_FPoint to = corners[(i + 1) % 3];
+            if ((from.y <= sample && sample < to.y) || (to.y <= sample && sample < from.y)) {
+                float x = from.x + (sample - from.y) * (to.x - from.x) / (to.y - from.y);
+                left = crossings == 0 ? x : std::min(left, x);
+                right = crossings == 0 ? x : std::max(right, x);
+                ++crossings;
+            }
+        }
+        if (crossings >= 2) {
+            addSpan(left, right, row, color);
+        }
+    }
+}
+
+void GeometryBatch::addCircle(float x, float y, float radius, SDL_Color color) {
+    float top = std::floor(y - radius);
+    float bottom = std::ceil(y + radius);
+    for (float row = top; row < bottom; row += 1.0f) {
+        float offset = row + 0.5f - y;
+        if (std::fabs(offset) < radius) {
+            float half = std::sqrt(radius * radius - offset * offset);
+            addSpan(x - half, x + half, row, color);
+        }
+    }
+}
+
+void GeometryBatch::draw(SDL_Renderer* renderer) const {
+    for (const Run& run : runs) {
+        SDL_SetRenderDrawColor(renderer, run.color.r, run.color.g, run.color.b, run.color.a);
+        if (run.points) {
+            SDL_RenderDrawPointsF(renderer, points.data() + run.first, static_cast<int>(run.count));
+        } else {
+            SDL_RenderFillRectsF(renderer, spans.data() + run.first, static_cast<int>(run.count));
+        }
+    }
+}
+
+#endif
+
+TextureLayer::~TextureLayer() {
+    release();
+}
+
+void TextureLayer::invalidate() {
+    valid = false;
+}
+
+void TextureLayer::release() {
+    if (texture != nullptr) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+    owner = nullptr;
+    valid = false;
+}
+
+void TextureLayer::draw(SDL_Renderer* renderer, int layerWidth, int layerHeight,
+                        const std::function<void(SDL_Renderer*)>& build) {
+    if (renderer != owner || layerWidth != width || layerHeight != height) {
+        release();
+        owner = renderer;
+        width = layerWidth;
+        height = layerHeight;
+        texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        if (texture != nullptr) {
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        }
+    }
+    if (texture == nullptr) {
+        build(renderer);
+        return;
+    }
+
+    if (!valid) {
+        SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+        Uint8 r, g, b, a;
+        SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+        SDL_SetRenderTarget(renderer, texture);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+        build(renderer);
+        SDL_SetRenderTarget(renderer, previousTarget);
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+        valid = true;
+    }
+
+    SDL_Rect destination = {0, 0, width, height};
+    SDL_RenderCopy(renderer, texture, nullptr, &destination);
+}
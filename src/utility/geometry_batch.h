@@ -0,0 +1,89 @@
+// geometry_batch.h
+#ifndef GEOMETRY_BATCH_H
+#define GEOMETRY_BATCH_H
+
+#include <SDL2/SDL.h>
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define GEOMETRY_BATCH_RENDER_GEOMETRY 1
+#else
+#define GEOMETRY_BATCH_RENDER_GEOMETRY 0
+#endif
+
+// Collects one layer's shapes (stars, planets, ships, projectiles) and submits them
+// together instead of one draw call per object. With SDL 2.0.18 or later the whole
+// layer is a single SDL_RenderGeometry call. Older SDL has no geometry call, so shapes
+// are cut into horizontal spans for SDL_RenderFillRectsF and points go to
+// SDL_RenderDrawPointsF, one call per run of same-coloured primitives.
+// clear() keeps capacity, so rebuilding a layer every frame does not allocate.
+class GeometryBatch {
+public:
+    void clear();
+    bool empty() const;
+
+    void addPoint(float x, float y, SDL_Color color);
+    void addRect(const SDL_FRect& rect, SDL_Color color);
+    void addTriangle(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_Color color);
+    void addCircle(float x, float y, float radius, SDL_Color color);
+
+    void draw(SDL_Renderer* renderer) const;
+
+private:
+#if GEOMETRY_BATCH_RENDER_GEOMETRY
+    void addVertex(float x, float y, SDL_Color color);
+
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+#else
+    struct Run {
+        SDL_Color color;
+        bool points;
+        std::size_t first;
+        std::size_t count;
+    };
+
+    // Extends the last run when colour and kind match, so a layer drawn in one colour is one call
+    void extendRun(SDL_Color color, bool points, std::size_t first, std::size_t count);
+    void addSpan(float left, float right, float top, SDL_Color color);
+
+    std::vector<Run> runs;
+    std::vector<SDL_FPoint> points;
+    std::vector<SDL_FRect> spans;
+#endif
+};
+
+// Content that rarely changes, such as the star field, drawn once into a target
+// texture and copied to the screen each frame, so its cost no longer depends on how
+// many objects it holds. If the renderer cannot render to textures, the content is
+// drawn directly every frame instead.
+class TextureLayer {
+public:
+    TextureLayer() = default;
+    ~TextureLayer();
+
+    TextureLayer(const TextureLayer&) = delete;
+    TextureLayer& operator=(const TextureLayer&) = delete;
+
+    // Redraws the content on the next draw(). Call it when the content changes, and on
+    // SDL_RENDER_TARGETS_RESET, which discards what target textures hold.
+    void invalidate();
+
+    // Textures belong to their renderer: call this before destroying the renderer.
+    void release();
+
+    // build draws the content onto a cleared, transparent texture of width by height.
+    void draw(SDL_Renderer* renderer, int width, int height, const std::function<void(SDL_Renderer*)>& build);
+
+private:
+    SDL_Renderer* owner = nullptr;
+    SDL_Texture* texture = nullptr;
+    int width = 0;
+    int height = 0;
+    bool valid = false;
+};
+
+#endif
@@ -0,0 +1,69 @@
+// mapped_file.cpp
+#include "mapped_file.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILE_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef MAPPED_FILE_POSIX
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0 || status.st_size <= 0) {
+        ::close(descriptor);
+        return false;
+    }
+    void* mapping = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    // The mapping keeps its own reference to the file
+    ::close(descriptor);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    bytes = static_cast<const std::uint8_t*>(mapping);
+    length = static_cast<std::size_t>(status.st_size);
+    return true;
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    std::streamoff fileLength = file.tellg();
+    if (fileLength <= 0) {
+        return false;
+    }
+    file.seekg(0, std::ios::beg);
+    fallback.resize(static_cast<std::size_t>(fileLength));
+    if (!file.read(reinterpret_cast<char*>(fallback.data()), fileLength)) {
+        fallback.clear();
+        return false;
+    }
+    length = fallback.size();
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+#ifdef MAPPED_FILE_POSIX
+    if (bytes != nullptr) {
+        ::munmap(const_cast<std::uint8_t*>(bytes), length);
+    }
+#endif
+    bytes = nullptr;
+    length = 0;
+    fallback.clear();
+}
@@ -0,0 +1,34 @@
+// mapped_file.h
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only view of a whole file. On POSIX systems the file is memory-mapped, so
+// opening is O(1) and pages are only read from disk when they are first touched.
+// Elsewhere the file is read into memory up front.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return bytes != nullptr || fallback.size() > 0; }
+    const std::uint8_t* data() const { return bytes != nullptr ? bytes : fallback.data(); }
+    std::size_t size() const { return length; }
+
+private:
+    const std::uint8_t* bytes = nullptr;
+    std::size_t length = 0;
+    std::vector<std::uint8_t> fallback;
+};
+
+#endif
@@ -0,0 +1,207 @@
+// metrics.cpp
+#include "metrics.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::uint64_t> allocations{0};
+
+std::string formatNumber(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.6g", value);
+    return text;
+}
+
+} // namespace
+
+// Counting replacement for the global allocator, linked in with the registry. Array and
+// nothrow forms go through these by default.
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size > 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+std::uint64_t allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+int MetricHistogram::bucketOf(std::uint64_t value) {
+    if (value < 8) {
+        return static_cast<int>(value);
+    }
+    int exponent = 63 - __builtin_clzll(value);
+    int quarter = static_cast<int>((value >> (exponent - 2)) & 3);
+    return 8 + (exponent - 3) * 4 + quarter;
+}
+
+std::uint64_t MetricHistogram::bucketLowerBound(int bucket) {
+    if (bucket < 8) {
+        return static_cast<std::uint64_t>(bucket);
+    }
+    int exponent = (bucket - 8) / 4 + 3;
+    std::uint64_t quarter = static_cast<std::uint64_t>((bucket - 8) % 4);
+    return (4 + quarter) << (exponent - 2);
+}
+
+void MetricHistogram::record(std::uint64_t value) {
+    buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+    std::uint64_t largest = max.load(std::memory_order_relaxed);
+    while (value > largest && !max.compare_exchange_weak(largest, value, std::memory_order_relaxed)) {
+    }
+}
+
+// A value recorded while a window is being reset may be counted in either window.
+MetricHistogram::Summary MetricHistogram::summarize(bool reset) {
+    std::array<std::uint64_t, kBuckets> counts;
+    std::uint64_t total = 0;
+    for (int bucket = 0; bucket < kBuckets; ++bucket) {
+        counts[bucket] = reset ? buckets[bucket].exchange(0, std::memory_order_relaxed)
+                               : buckets[bucket].load(std::memory_order_relaxed);
+        total += counts[bucket];
+    }
+
+    Summary summary;
+    summary.count = total;
+    summary.sum = reset ? sum.exchange(0, std::memory_order_relaxed) : sum.load(std::memory_order_relaxed);
+    summary.max = reset ? max.exchange(0, std::memory_order_relaxed) : max.load(std::memory_order_relaxed);
+    if (total == 0) {
+        return summary;
+    }
+
+    std::uint64_t p50Rank = (total + 1) / 2;
+    std::uint64_t p95Rank = total - total / 20;
+    std::uint64_t seen = 0;
+    bool p50Found = false;
+    for (int bucket = 0; bucket < kBuckets; ++bucket) {
+        seen += counts[bucket];
+        if (!p50Found && seen >= p50Rank) {
+            summary.p50 = bucketLowerBound(bucket);
+            p50Found = true;
+        }
+        if (seen >= p95Rank) {
+            summary.p95 = bucketLowerBound(bucket);
+            break;
+        }
+    }
+    return summary;
+}
+
+MetricCounter& MetricsRegistry::counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<CounterEntry>& entry = counters[name];
+    if (!entry) {
+        entry = std::make_unique<CounterEntry>();
+    }
+    return entry->counter;
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<MetricGauge>& gauge = gauges[name];
+    if (!gauge) {
+        gauge = std::make_unique<MetricGauge>();
+    }
+    return *gauge;
+}
+
+MetricHistogram& MetricsRegistry::histogram(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<MetricHistogram>& histogram = histograms[name];
+    if (!histogram) {
+        histogram = std::make_unique<MetricHistogram>();
+    }
+    return *histogram;
+}
+
+std::vector<MetricSample> MetricsRegistry::collect(bool startNewWindow) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<MetricSample> samples;
+    samples.reserve(counters.size() + gauges.size() + histograms.size());
+
+    for (auto& [name, entry] : counters) {
+        std::uint64_t total = entry->counter.get();
+        MetricSample sample;
+        sample.name = name;
+        sample.kind = MetricSample::Counter;
+        sample.value = static_cast<double>(total - entry->windowStart);
+        samples.push_back(std::move(sample));
+        if (startNewWindow) {
+            entry->windowStart = total;
+        }
+    }
+    for (auto& [name, gauge] : gauges) {
+        MetricSample sample;
+        sample.name = name;
+        sample.kind = MetricSample::Gauge;
+        sample.value = gauge->get();
+        samples.push_back(std::move(sample));
+    }
+    for (auto& [name, histogram] : histograms) {
+        MetricSample sample;
+        sample.name = name;
+        sample.kind = MetricSample::Histogram;
+        sample.histogram = histogram->summarize(startNewWindow);
+        if (sample.histogram.count > 0) {
+            sample.value = static_cast<double>(sample.histogram.sum) / static_cast<double>(sample.histogram.count);
+        }
+        samples.push_back(std::move(sample));
+    }
+    return samples;
+}
+
+MetricsRegistry& metricsRegistry() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+std::string formatMetricSample(const MetricSample& sample) {
+    std::string line = sample.name + "  ";
+    if (sample.kind != MetricSample::Histogram) {
+        return line + formatNumber(sample.value);
+    }
+    const MetricHistogram::Summary& histogram = sample.histogram;
+    return line + "n " + std::to_string(histogram.count) + "  p50 " + std::to_string(histogram.p50) + "  p95 " +
+           std::to_string(histogram.p95) + "  max " + std::to_string(histogram.max);
+}
+
+void MetricsCsvLog::endTurn(MetricsRegistry& registry, std::uint32_t turn) {
+    static const char* const kKinds[] = {"counter", "gauge", "histogram"};
+
+    rows.clear();
+    if (!started) {
+        rows = "turn,metric,kind,value,count,p50,p95,max\n";
+    }
+    for (const MetricSample& sample : registry.collect(true)) {
+        const MetricHistogram::Summary& histogram = sample.histogram;
+        rows += std::to_string(turn) + ',' + sample.name + ',' + kKinds[sample.kind] + ',' + formatNumber(sample.value);
+        if (sample.kind == MetricSample::Histogram) {
+            rows += ',' + std::to_string(histogram.count) + ',' + std::to_string(histogram.p50) + ',' +
+                    std::to_string(histogram.p95) + ',' + std::to_string(histogram.max) + '\n';
+        } else {
+            rows += ",,,,\n";
+        }
+    }
+
+    const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(rows.data());
+    if (started) {
+        writer.append(path, bytes, rows.size());
+    } else {
+        writer.submit(path, bytes, rows.size());
+        started = true;
+    }
+}
@@ -0,0 +1,144 @@
+// metrics.h
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "async_file_writer.h"
+
+// Runtime metrics for the overlay and the per-turn CSV. Every metric can be fed from
+// any thread without a lock; metrics are looked up by name once (under the registry's
+// lock) and the reference kept, since it stays valid for the registry's lifetime.
+//
+// Counters and histograms are read per window: a counter reports what was added and
+// a histogram the values recorded since the last collect(true), normally the last turn.
+
+class MetricCounter {
+public:
+    void add(std::uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+    std::uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> value{0};
+};
+
+class MetricGauge {
+public:
+    void set(double newValue) { value.store(newValue, std::memory_order_relaxed); }
+    double get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> value{0.0};
+};
+
+// Non-negative integer samples (microseconds, counts) in log-scale buckets: exact below
+// 8, then four buckets per power of two, so percentiles are within 12.5%.
+class MetricHistogram {
+public:
+    struct Summary {
+        std::uint64_t count = 0;
+        std::uint64_t sum = 0;
+        std::uint64_t p50 = 0;
+        std::uint64_t p95 = 0;
+        std::uint64_t max = 0;
+    };
+
+    void record(std::uint64_t value);
+    // Percentiles are the lower bound of the bucket they fall in. reset starts a new window.
+    Summary summarize(bool reset);
+
+    static constexpr int kBuckets = 252;
+    static int bucketOf(std::uint64_t value);
+    static std::uint64_t bucketLowerBound(int bucket);
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBuckets> buckets{};
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<std::uint64_t> max{0};
+};
+
+// Records the microseconds from construction to destruction.
+class ScopedMetricTimer {
+public:
+    explicit ScopedMetricTimer(MetricHistogram& histogram)
+        : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+    ~ScopedMetricTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        histogram.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+
+    ScopedMetricTimer(const ScopedMetricTimer&) = delete;
+    ScopedMetricTimer& operator=(const ScopedMetricTimer&) = delete;
+
+private:
+    MetricHistogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+struct MetricSample {
+    enum Kind { Counter, Gauge, Histogram };
+
+    std::string name;
+    Kind kind = Counter;
+    // Counter: added this window. Gauge: current value. Histogram: mean.
+    double value = 0.0;
+    MetricHistogram::Summary histogram;
+};
+
+class MetricsRegistry {
+public:
+    // The same name always returns the same metric.
+    MetricCounter& counter(const std::string& name);
+    MetricGauge& gauge(const std::string& name);
+    MetricHistogram& histogram(const std::string& name);
+
+    // Every metric, sorted by kind then name. startNewWindow ends the window the
+    // counters and histograms report on.
+    std::vector<MetricSample> collect(bool startNewWindow);
+
+private:
+    struct CounterEntry {
+        MetricCounter counter;
+        std::uint64_t windowStart = 0;
+    };
+
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<CounterEntry>> counters;
+    std::map<std::string, std::unique_ptr<MetricGauge>> gauges;
+    std::map<std::string, std::unique_ptr<MetricHistogram>> histograms;
+};
+
+// The registry the game feeds.
+MetricsRegistry& metricsRegistry();
+
+// Allocations made through operator new by every thread since the program started.
+std::uint64_t allocationCount();
+
+// One overlay line, e.g. "tick_us  n 60  p50 812  p95 1450  max 3021".
+std::string formatMetricSample(const MetricSample& sample);
+
+// Writes one CSV row per metric at the end of every turn:
+//   turn,metric,kind,value,count,p50,p95,max
+// The first turn replaces the file; later turns are appended. Writes happen on a
+// background thread.
+class MetricsCsvLog {
+public:
+    explicit MetricsCsvLog(std::string path) : path(std::move(path)) {}
+
+    void endTurn(MetricsRegistry& registry, std::uint32_t turn);
+
+private:
+    std::string path;
+    std::string rows;
+    bool started = false;
+    AsyncFileWriter writer;
+};
+
+#endif
@@ -0,0 +1,194 @@
+// profiler.cpp
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct ProfileEvent {
+    const char* name;
+    std::uint64_t start;
+    std::uint64_t duration;
+    std::uint32_t depth;
+};
+
+// One thread's zones. Only the owning thread writes; the trace writer copies slots
+// seqlock-style, using reserved to spot the ones overwritten while it read them. The
+// slot fields are relaxed atomics so that read is not a data race.
+struct ProfileRing {
+    struct Slot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<std::uint64_t> start{0};
+        std::atomic<std::uint64_t> duration{0};
+        std::atomic<std::uint32_t> depth{0};
+    };
+
+    explicit ProfileRing(std::uint32_t threadId) : threadId(threadId), slots(kProfileRingCapacity) {}
+
+    void push(const ProfileEvent& event) {
+        std::uint64_t index = written.load(std::memory_order_relaxed);
+        reserved.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        Slot& slot = slots[index % kProfileRingCapacity];
+        slot.name.store(event.name, std::memory_order_relaxed);
+        slot.start.store(event.start, std::memory_order_relaxed);
+        slot.duration.store(event.duration, std::memory_order_relaxed);
+        slot.depth.store(event.depth, std::memory_order_relaxed);
+        written.store(index + 1, std::memory_order_release);
+    }
+
+    void copyTo(std::vector<ProfileEvent>& events) const {
+        std::uint64_t end = written.load(std::memory_order_acquire);
+        std::uint64_t begin = end > kProfileRingCapacity ? end - kProfileRingCapacity : 0;
+        std::size_t first = events.size();
+        for (std::uint64_t index = begin; index < end; ++index) {
+            const Slot& slot = slots[index % kProfileRingCapacity];
+            events.push_back({slot.name.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed),
+                              slot.duration.load(std::memory_order_relaxed), slot.depth.load(std::memory_order_relaxed)});
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        std::uint64_t after = reserved.load(std::memory_order_relaxed);
+        std::uint64_t overwritten = after > begin + kProfileRingCapacity ? after - begin - kProfileRingCapacity : 0;
+        if (overwritten > 0) {
+            auto from = events.begin() + static_cast<std::ptrdiff_t>(first);
+            events.erase(from, from + static_cast<std::ptrdiff_t>(std::min<std::uint64_t>(overwritten, end - begin)));
+        }
+    }
+
+    const std::uint32_t threadId;
+    // Owned by the registry's mutex
+    const char* threadName = nullptr;
+    // Owned by the recording thread
+    std::uint32_t depth = 0;
+
+    std::vector<Slot> slots;
+    std::atomic<std::uint64_t> reserved{0};
+    std::atomic<std::uint64_t> written{0};
+};
+
+struct ProfileRegistry {
+    std::atomic<bool> enabled{false};
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ProfileRing>> rings;
+};
+
+ProfileRegistry& profileRegistry() {
+    static ProfileRegistry registry;
+    return registry;
+}
+
+thread_local ProfileRing* threadRing = nullptr;
+thread_local const char* threadName = nullptr;
+
+// Rings are created on a thread's first zone, so threads that never record cost nothing.
+ProfileRing& threadProfileRing() {
+    if (threadRing == nullptr) {
+        ProfileRegistry& registry = profileRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.rings.push_back(std::make_unique<ProfileRing>(static_cast<std::uint32_t>(registry.rings.size() + 1)));
+        threadRing = registry.rings.back().get();
+        threadRing->threadName = threadName;
+    }
+    return *threadRing;
+}
+
+void writeEscaped(std::ostream& out, const char* text) {
+    for (; *text != '\0'; ++text) {
+        if (*text == '"' || *text == '\\') {
+            out << '\\';
+        }
+        out << *text;
+    }
+}
+
+// Chrome trace timestamps are microseconds; three decimals keep the nanoseconds.
+void writeMicroseconds(std::ostream& out, std::uint64_t nanoseconds) {
+    out << nanoseconds / 1000 << '.';
+    std::uint64_t fraction = nanoseconds % 1000;
+    out << (fraction < 100 ? "0" : "") << (fraction < 10 ? "0" : "") << fraction;
+}
+
+} // namespace
+
+ProfileZone::ProfileZone(const char* name) : name(isProfilingEnabled() ? name : nullptr) {
+    if (this->name != nullptr) {
+        depth = threadProfileRing().depth++;
+        start = profileNanoseconds();
+    }
+}
+
+ProfileZone::~ProfileZone() {
+    if (name != nullptr) {
+        std::uint64_t end = profileNanoseconds();
+        ProfileRing& ring = threadProfileRing();
+        --ring.depth;
+        ring.push({name, start, end - start, depth});
+    }
+}
+
+void setProfilingEnabled(bool enabled) {
+    profileRegistry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool isProfilingEnabled() {
+    return profileRegistry().enabled.load(std::memory_order_relaxed);
+}
+
+void setProfileThreadName(const char* name) {
+    threadName = name;
+    if (threadRing != nullptr) {
+        std::lock_guard<std::mutex> lock(profileRegistry().mutex);
+        threadRing->threadName = name;
+    }
+}
+
+std::uint64_t profileNanoseconds() {
+    auto elapsed = std::chrono::steady_clock::now() - profileRegistry().epoch;
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+bool writeProfileTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    ProfileRegistry& registry = profileRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::vector<ProfileEvent> events;
+    events.reserve(kProfileRingCapacity);
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const std::unique_ptr<ProfileRing>& ring : registry.rings) {
+        if (ring->threadName != nullptr) {
+            out << (first ? "\n" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << ring->threadId
+                << ",\"args\":{\"name\":\"";
+            writeEscaped(out, ring->threadName);
+            out << "\"}}";
+            first = false;
+        }
+
+        events.clear();
+        ring->copyTo(events);
+        for (const ProfileEvent& event : events) {
+            out << (first ? "\n" : ",\n") << "{\"ph\":\"X\",\"name\":\"";
+            writeEscaped(out, event.name);
+            out << "\",\"pid\":1,\"tid\":" << ring->threadId << ",\"ts\":";
+            writeMicroseconds(out, event.start);
+            out << ",\"dur\":";
+            writeMicroseconds(out, event.duration);
+            out << ",\"args\":{\"depth\":" << event.depth << "}}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,47 @@
+// profiler.h
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Frame profiler. A ProfileZone records when its scope started, how long it took, on
+// which thread and how deeply it was nested in other zones; writeProfileTrace() saves
+// every recorded zone as a Chrome trace, which chrome://tracing and ui.perfetto.dev open.
+// While profiling is off a zone costs a call and a relaxed load.
+//
+// Each thread records into its own ring buffer without taking a lock. A thread's buffer
+// holds its last kProfileRingCapacity zones; older ones are overwritten. Buffers outlive
+// their threads, so a trace can be written after the threads that filled it are joined.
+class ProfileZone {
+public:
+    // name must outlive the profiler; in practice, a string literal.
+    explicit ProfileZone(const char* name);
+    ~ProfileZone();
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name;
+    std::uint64_t start = 0;
+    std::uint32_t depth = 0;
+};
+
+constexpr std::size_t kProfileRingCapacity = std::size_t(1) << 16;
+
+void setProfilingEnabled(bool enabled);
+bool isProfilingEnabled();
+
+// Names the calling thread in the trace. name must outlive the profiler.
+void setProfileThreadName(const char* name);
+
+// Nanoseconds since the profiler's epoch, on the clock zones are timed with.
+std::uint64_t profileNanoseconds();
+
+// Writes every zone still held in the ring buffers. Safe to call while other threads
+// are recording; zones they overwrite during the copy are left out.
+bool writeProfileTrace(const std::string& path);
+
+#endif
@@ -0,0 +1,107 @@
+// random_streams.cpp
+#include "random_streams.h"
+
+#include <bitset>
+#include <limits>
+
+namespace {
+
+// Odd increments with well-spread bits, as in SplittableRandom; a gamma with few
+// bit transitions gives visibly correlated neighbouring values.
+std::uint64_t mixGamma(std::uint64_t z) {
+    z = random_streams::mix64(z) | 1;
+    if (std::bitset<64>(z ^ (z >> 1)).count() < 24) {
+        z ^= 0xAAAAAAAAAAAAAAAAull;
+    }
+    return z;
+}
+
+std::uint64_t streamKey(std::uint32_t subsystem, std::uint64_t id) {
+    return random_streams::mix64(static_cast<std::uint64_t>(subsystem) << 32 ^ random_streams::mix64(id));
+}
+
+} // namespace
+
+RandomStream::RandomStream(std::uint64_t seed, std::uint64_t streamId) {
+    std::uint64_t base = random_streams::mix64(seed ^ random_streams::mix64(streamId + random_streams::kGoldenGamma));
+    key = random_streams::mix64(base);
+    gamma = mixGamma(base + random_streams::kGoldenGamma);
+}
+
+RandomStream RandomStream::split(std::uint64_t streamId) const {
+    return RandomStream(key ^ gamma, streamId);
+}
+
+int RandomStream::nextInt(int min, int max) {
+    std::uint64_t range = static_cast<std::uint64_t>(static_cast<std::int64_t>(max) - min) + 1;
+    if (range > std::numeric_limits<std::uint32_t>::max()) {
+        return static_cast<int>(static_cast<std::int64_t>(min) + static_cast<std::int64_t>(next() >> 32));
+    }
+    // Lemire's multiply-and-shift; the rare low products are redrawn so every value is equally likely
+    std::uint64_t product = (next() >> 32) * range;
+    std::uint32_t low = static_cast<std::uint32_t>(product);
+    if (low < range) {
+        std::uint32_t threshold = static_cast<std::uint32_t>(-static_cast<std::uint32_t>(range)) % static_cast<std::uint32_t>(range);
+        while (low < threshold) {
+            product = (next() >> 32) * range;
+            low = static_cast<std::uint32_t>(product);
+        }
+    }
+    return static_cast<int>(static_cast<std::int64_t>(min) + static_cast<std::int64_t>(product >> 32));
+}
+
+void RandomStream::fill(std::uint64_t* out, std::size_t count) {
+    std::uint64_t first = key + (position + 1) * gamma;
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = random_streams::mix64(first + i * gamma);
+    }
+    position += count;
+}
+
+void RandomStream::fillDoubles(double* out, std::size_t count, double min, double max) {
+    std::uint64_t first = key + (position + 1) * gamma;
+    double scale = (max - min) * 0x1.0p-53;
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = min + static_cast<double>(random_streams::mix64(first + i * gamma) >> 11) * scale;
+    }
+    position += count;
+}
+
+void RandomService::reseed(std::uint64_t newSeed) {
+    seed = newSeed;
+    streams.clear();
+    created.clear();
+}
+
+RandomStream& RandomService::getStream(std::uint32_t subsystem) {
+    if (subsystem >= streams.size()) {
+        streams.resize(subsystem + 1);
+        created.resize(subsystem + 1, 0);
+    }
+    if (!created[subsystem]) {
+        streams[subsystem] = RandomStream(seed, streamKey(subsystem, 0));
+        created[subsystem] = 1;
+    }
+    return streams[subsystem];
+}
+
+RandomStream RandomService::entityStream(std::uint32_t subsystem, std::uint64_t entity) const {
+    return RandomStream(seed, streamKey(subsystem, entity + 1));
+}
+
+RandomStream RandomService::taskStream(std::uint32_t subsystem, std::uint64_t tick, std::uint64_t task) const {
+    return entityStream(subsystem, task).split(tick);
+}
+
+RandomStream& threadRandomStream() {
+    thread_local RandomStream stream;
+    return stream;
+}
+
+ScopedRandomStream::ScopedRandomStream(const RandomStream& stream) : saved(threadRandomStream()) {
+    threadRandomStream() = stream;
+}
+
+ScopedRandomStream::~ScopedRandomStream() {
+    threadRandomStream() = saved;
+}
@@ -0,0 +1,106 @@
+// random_streams.h
+#ifndef RANDOM_STREAMS_H
+#define RANDOM_STREAMS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace random_streams {
+
+constexpr std::uint64_t kGoldenGamma = 0x9E3779B97F4A7C15ull;
+
+// SplitMix64 finaliser: a bijective mix of all 64 bits.
+constexpr std::uint64_t mix64(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+} // namespace random_streams
+
+// Counter-based random numbers (SplitMix64). The n-th value of a stream is a pure
+// function of the stream's key and n, so streams share no state: they can be handed
+// to subsystems, entities or parallel tasks without locks, drawing from one never
+// shifts another, and a stream's position is a single integer.
+class RandomStream {
+public:
+    // Stream 0 of seed 0.
+    RandomStream() : RandomStream(0, 0) {}
+    RandomStream(std::uint64_t seed, std::uint64_t streamId);
+
+    // A child stream, independent of this one and of children with other ids.
+    RandomStream split(std::uint64_t streamId) const;
+
+    // The value at a given position; does not move the stream.
+    std::uint64_t at(std::uint64_t index) const {
+        return random_streams::mix64(key + (index + 1) * gamma);
+    }
+
+    std::uint64_t next() { return at(position++); }
+
+    // Uniform in [0, 1) with 53 random bits.
+    double nextDouble() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+    double nextDouble(double min, double max) { return min + (max - min) * nextDouble(); }
+
+    // Uniform in [min, max], without the modulo bias of rand() % n.
+    int nextInt(int min, int max);
+
+    // Bulk generation for rollouts: out[i] is the value at getPosition() + i, and the
+    // stream moves past all of them. No state is carried between iterations, so the
+    // loop can be vectorised.
+    void fill(std::uint64_t* out, std::size_t count);
+    void fillDoubles(double* out, std::size_t count, double min = 0.0, double max = 1.0);
+
+    std::uint64_t getPosition() const { return position; }
+    void setPosition(std::uint64_t index) { position = index; }
+
+private:
+    std::uint64_t key;
+    std::uint64_t gamma;
+    std::uint64_t position = 0;
+};
+
+// The game seed and one long-lived stream per subsystem. Entity and task streams are
+// derived on demand from (subsystem, id), so the same arguments give the same stream
+// on any thread. Parallel work should key its stream on the task or entity it is
+// processing rather than on the worker thread, which varies between runs.
+class RandomService {
+public:
+    explicit RandomService(std::uint64_t seed = 0) : seed(seed) {}
+
+    // Resets every subsystem stream.
+    void reseed(std::uint64_t newSeed);
+    std::uint64_t getSeed() const { return seed; }
+
+    // Created on first use; not thread-safe, so only the owning thread draws from it.
+    RandomStream& getStream(std::uint32_t subsystem);
+
+    RandomStream entityStream(std::uint32_t subsystem, std::uint64_t entity) const;
+    // A fresh stream for one task of one tick, e.g. a parallelFor chunk.
+    RandomStream taskStream(std::uint32_t subsystem, std::uint64_t tick, std::uint64_t task) const;
+
+private:
+    std::uint64_t seed;
+    std::vector<RandomStream> streams;
+    std::vector<std::uint8_t> created;
+};
+
+// The stream randomDouble() and randomInt() draw from on the calling thread. Every
+// thread starts with its own default stream.
+RandomStream& threadRandomStream();
+
+// Makes stream the calling thread's stream until the end of the scope.
+class ScopedRandomStream {
+public:
+    explicit ScopedRandomStream(const RandomStream& stream);
+    ~ScopedRandomStream();
+
+    ScopedRandomStream(const ScopedRandomStream&) = delete;
+    ScopedRandomStream& operator=(const ScopedRandomStream&) = delete;
+
+private:
+    RandomStream saved;
+};
+
+#endif
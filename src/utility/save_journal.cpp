@@ -0,0 +1,156 @@
+// save_journal.cpp
+#include "save_journal.h"
+
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace {
+
+constexpr char kJournalMagic[4] = {'S', 'W', 'H', 'J'};
+constexpr char kRecordMagic[4] = {'S', 'W', 'H', 'D'};
+constexpr std::uint32_t kJournalVersion = 1;
+constexpr std::size_t kJournalHeaderSize = 24;
+constexpr std::size_t kRecordHeaderSize = 16;
+
+std::uint64_t hashBytes(const std::uint8_t* data, std::size_t size) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+template <typename T>
+void appendValue(std::vector<std::uint8_t>& buffer, T value) {
+    std::size_t at = buffer.size();
+    buffer.resize(at + sizeof(T));
+    binary_archive::copyLittleEndian<T>(&buffer[at], &value, 1);
+}
+
+template <typename T>
+T readValue(const std::uint8_t* data) {
+    T value;
+    binary_archive::copyLittleEndian<T>(&value, data, 1);
+    return value;
+}
+
+bool readWholeFile(const std::string& path, std::vector<std::uint8_t>& bytes) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    std::streamoff length = file.tellg();
+    if (length < 0) {
+        return false;
+    }
+    file.seekg(0, std::ios::beg);
+    bytes.resize(static_cast<std::size_t>(length));
+    return length == 0 || static_cast<bool>(file.read(reinterpret_cast<char*>(bytes.data()), length));
+}
+
+} // namespace
+
+SaveJournal::SaveJournal(const std::string& basePath, std::vector<RaggedColumns> raggedColumns, AsyncFileWriter& writer)
+    : checkpointPath(basePath + ".dat"), journalPath(basePath + ".journal"),
+      raggedColumns(std::move(raggedColumns)), writer(writer) {}
+
+void SaveJournal::reset() {
+    hasCheckpoint = false;
+    previous.clear();
+}
+
+bool SaveJournal::record(std::uint32_t turn, const std::vector<std::uint8_t>& archive) {
+    ArchiveReader current;
+    if (!current.open(archive.data(), archive.size())) {
+        return false;
+    }
+    bool checkpointDue = !hasCheckpoint || turn < checkpointTurn || turn - checkpointTurn >= checkpointInterval ||
+                         journalBytes > checkpointBytes / 2;
+    ArchiveReader last;
+    if (checkpointDue || !last.open(previous.data(), previous.size())) {
+        writeCheckpoint(turn, archive);
+        previous = archive;
+        return true;
+    }
+
+    if (!encodeArchiveDelta(last, current, raggedColumns, deltaWriter)) {
+        // Nothing changed; restoring this turn finds the previous record's state
+        return true;
+    }
+    const std::vector<std::uint8_t>& delta = deltaWriter.getBuffer();
+    ArchiveReader encoded;
+    if (!encoded.open(delta.data(), delta.size())) {
+        // restore() would stop at this record and lose every later turn
+        writeCheckpoint(turn, archive);
+        previous = archive;
+        return true;
+    }
+    recordBuffer.resize(4);
+    std::memcpy(recordBuffer.data(), kRecordMagic, 4);
+    appendValue<std::uint32_t>(recordBuffer, turn);
+    appendValue<std::uint64_t>(recordBuffer, delta.size());
+    recordBuffer.insert(recordBuffer.end(), delta.begin(), delta.end());
+    writer.append(journalPath, recordBuffer.data(), recordBuffer.size());
+    journalBytes += recordBuffer.size();
+    previous = archive;
+    return true;
+}
+
+void SaveJournal::writeCheckpoint(std::uint32_t turn, const std::vector<std::uint8_t>& archive) {
+    writer.submit(checkpointPath, archive.data(), archive.size());
+
+    recordBuffer.resize(4);
+    std::memcpy(recordBuffer.data(), kJournalMagic, 4);
+    appendValue<std::uint32_t>(recordBuffer, kJournalVersion);
+    appendValue<std::uint32_t>(recordBuffer, turn);
+    appendValue<std::uint32_t>(recordBuffer, 0);
+    appendValue<std::uint64_t>(recordBuffer, hashBytes(archive.data(), archive.size()));
+    writer.submit(journalPath, recordBuffer.data(), recordBuffer.size());
+
+    hasCheckpoint = true;
+    checkpointTurn = turn;
+    checkpointBytes = archive.size();
+    journalBytes = recordBuffer.size();
+}
+
+bool SaveJournal::restore(const std::string& basePath, std::vector<std::uint8_t>& archive, std::uint32_t& turn,
+                          std::uint32_t maxTurn) {
+    ArchiveReader base;
+    if (!readWholeFile(basePath + ".dat", archive) || !base.open(archive.data(), archive.size())) {
+        return false;
+    }
+    std::vector<std::uint8_t> journal;
+    if (!readWholeFile(basePath + ".journal", journal) || journal.size() < kJournalHeaderSize ||
+        std::memcmp(journal.data(), kJournalMagic, 4) != 0 ||
+        readValue<std::uint32_t>(journal.data() + 4) != kJournalVersion ||
+        readValue<std::uint64_t>(journal.data() + 16) != hashBytes(archive.data(), archive.size())) {
+        // A checkpoint without its journal is still a complete save, just of an unknown turn
+        turn = 0;
+        return true;
+    }
+    turn = readValue<std::uint32_t>(journal.data() + 8);
+    if (turn > maxTurn) {
+        return false;
+    }
+
+    ArchiveReader delta;
+    ArchiveWriter rebuilt;
+    std::size_t at = kJournalHeaderSize;
+    while (journal.size() - at >= kRecordHeaderSize && std::memcmp(journal.data() + at, kRecordMagic, 4) == 0) {
+        std::uint32_t recordTurn = readValue<std::uint32_t>(journal.data() + at + 4);
+        std::uint64_t length = readValue<std::uint64_t>(journal.data() + at + 8);
+        at += kRecordHeaderSize;
+        if (recordTurn > maxTurn || length > journal.size() - at ||
+            !delta.open(journal.data() + at, static_cast<std::size_t>(length)) ||
+            !applyArchiveDelta(base, delta, rebuilt)) {
+            break;
+        }
+        archive = rebuilt.getBuffer();
+        base.open(archive.data(), archive.size());
+        turn = recordTurn;
+        at += static_cast<std::size_t>(length);
+    }
+    return true;
+}
@@ -0,0 +1,65 @@
+// save_journal.h
+#ifndef SAVE_JOURNAL_H
+#define SAVE_JOURNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include "archive_delta.h"
+#include "async_file_writer.h"
+#include "binary_archive.h"
+
+// Per-turn saves kept as a full checkpoint plus a journal of deltas.
+//
+//   <base>.dat      the checkpoint, an ordinary archive that loads on its own
+//   <base>.journal  header: magic "SWHJ", version, checkpoint turn, reserved,
+//                   FNV-1a hash of the checkpoint
+//                   records: magic "SWHD", turn, length, then an archive delta
+//
+// A new checkpoint (compaction) is written every checkpointInterval turns, or sooner
+// once the journal outgrows half the checkpoint. The checkpoint is replaced first and
+// the journal header second, both atomically; a journal whose hash does not match the
+// checkpoint is ignored, and so is a record cut short by a crash.
+class SaveJournal {
+public:
+    SaveJournal(const std::string& basePath, std::vector<RaggedColumns> raggedColumns, AsyncFileWriter& writer);
+
+    void setCheckpointInterval(std::uint32_t turns) { checkpointInterval = turns > 0 ? turns : 1; }
+
+    // archive is the complete save for turn. Only the rows that changed since the last
+    // call are written, unless a checkpoint is due. False if archive does not parse.
+    bool record(std::uint32_t turn, const std::vector<std::uint8_t>& archive);
+
+    // The next record() writes a checkpoint, e.g. after loading a different game.
+    void reset();
+
+    const std::string& getCheckpointPath() const { return checkpointPath; }
+    const std::string& getJournalPath() const { return journalPath; }
+    std::size_t getJournalBytes() const { return journalBytes; }
+
+    // Rebuilds the latest save at or before maxTurn into archive. False if there is no
+    // usable checkpoint, or it is newer than maxTurn.
+    static bool restore(const std::string& basePath, std::vector<std::uint8_t>& archive, std::uint32_t& turn,
+                        std::uint32_t maxTurn = std::numeric_limits<std::uint32_t>::max());
+
+private:
+    void writeCheckpoint(std::uint32_t turn, const std::vector<std::uint8_t>& archive);
+
+    std::string checkpointPath;
+    std::string journalPath;
+    std::vector<RaggedColumns> raggedColumns;
+    AsyncFileWriter& writer;
+    std::uint32_t checkpointInterval = 50;
+    std::uint32_t checkpointTurn = 0;
+    std::size_t checkpointBytes = 0;
+    std::size_t journalBytes = 0;
+    bool hasCheckpoint = false;
+    // The last recorded archive, which the next delta is taken against
+    std::vector<std::uint8_t> previous;
+    ArchiveWriter deltaWriter;
+    std::vector<std::uint8_t> recordBuffer;
+};
+
+#endif
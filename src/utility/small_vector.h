@@ -0,0 +1,178 @@
+// small_vector.h
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+// Vector with room for N elements inside the object, so it only allocates once it
+// grows past N. Meant for short per-entity lists of ids and amounts: elements must be
+// trivially copyable, and are copied with memcpy and never destroyed.
+template <typename T, std::size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallVector elements must be trivially copyable");
+    static_assert(N > 0, "SmallVector needs inline capacity");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+    SmallVector(std::initializer_list<T> values) { assign(values.begin(), values.end()); }
+    SmallVector(const SmallVector& other) { assign(other.begin(), other.end()); }
+    SmallVector(SmallVector&& other) noexcept { take(other); }
+    ~SmallVector() { releaseHeap(); }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            releaseHeap();
+            take(other);
+        }
+        return *this;
+    }
+
+    T* data() { return elements; }
+    const T* data() const { return elements; }
+    std::size_t size() const { return count; }
+    std::size_t capacity() const { return capacityCount; }
+    bool empty() const { return count == 0; }
+    // True while the elements still fit in the object itself.
+    bool isInline() const { return elements == inlineElements; }
+
+    iterator begin() { return elements; }
+    iterator end() { return elements + count; }
+    const_iterator begin() const { return elements; }
+    const_iterator end() const { return elements + count; }
+
+    T& operator[](std::size_t index) { return elements[index]; }
+    const T& operator[](std::size_t index) const { return elements[index]; }
+    T& at(std::size_t index) {
+        checkIndex(index);
+        return elements[index];
+    }
+    const T& at(std::size_t index) const {
+        checkIndex(index);
+        return elements[index];
+    }
+    T& front() { return elements[0]; }
+    const T& front() const { return elements[0]; }
+    T& back() { return elements[count - 1]; }
+    const T& back() const { return elements[count - 1]; }
+
+    void reserve(std::size_t newCapacity) {
+        if (newCapacity <= capacityCount) {
+            return;
+        }
+        T* grown = new T[newCapacity];
+        if (count > 0) {
+            std::memcpy(grown, elements, count * sizeof(T));
+        }
+        releaseHeap();
+        elements = grown;
+        capacityCount = static_cast<std::uint32_t>(newCapacity);
+    }
+
+    void push_back(const T& value) {
+        if (count == capacityCount) {
+            // value may live in this vector, so it is copied before the storage moves
+            T copy = value;
+            reserve(std::size_t(capacityCount) * 2);
+            elements[count++] = copy;
+            return;
+        }
+        elements[count++] = value;
+    }
+
+    void pop_back() { --count; }
+    void clear() { count = 0; }
+
+    void resize(std::size_t newSize, const T& value = T()) {
+        reserve(newSize);
+        std::fill(elements + count, elements + std::max<std::size_t>(newSize, count), value);
+        count = static_cast<std::uint32_t>(newSize);
+    }
+
+    template <typename Iterator>
+    void assign(Iterator first, Iterator last) {
+        std::size_t newSize = static_cast<std::size_t>(std::distance(first, last));
+        if (newSize > capacityCount) {
+            count = 0;
+            reserve(newSize);
+        }
+        std::copy(first, last, elements);
+        count = static_cast<std::uint32_t>(newSize);
+    }
+
+    iterator erase(const_iterator position) { return erase(position, position + 1); }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        T* target = elements + (first - elements);
+        std::size_t removed = static_cast<std::size_t>(last - first);
+        std::size_t tail = static_cast<std::size_t>(end() - last);
+        if (removed > 0 && tail > 0) {
+            std::memmove(target, last, tail * sizeof(T));
+        }
+        count -= static_cast<std::uint32_t>(removed);
+        return target;
+    }
+
+    friend bool operator==(const SmallVector& left, const SmallVector& right) {
+        return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin());
+    }
+    friend bool operator!=(const SmallVector& left, const SmallVector& right) { return !(left == right); }
+
+private:
+    void checkIndex(std::size_t index) const {
+        if (index >= count) {
+            throw std::out_of_range("SmallVector::at");
+        }
+    }
+
+    void releaseHeap() {
+        if (!isInline()) {
+            delete[] elements;
+            elements = inlineElements;
+            capacityCount = N;
+        }
+    }
+
+    // Leaves other empty and inline.
+    void take(SmallVector& other) {
+        if (other.isInline()) {
+            std::memcpy(inlineElements, other.inlineElements, other.count * sizeof(T));
+            elements = inlineElements;
+            capacityCount = N;
+        } else {
+            elements = other.elements;
+            capacityCount = other.capacityCount;
+            other.elements = other.inlineElements;
+            other.capacityCount = N;
+        }
+        count = other.count;
+        other.count = 0;
+    }
+
+    T* elements = inlineElements;
+    std::uint32_t count = 0;
+    std::uint32_t capacityCount = N;
+    T inlineElements[N];
+};
+
+#endif
@@ -0,0 +1,49 @@
+// triple_buffer.h
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free handoff of whole values from one producer thread to one consumer thread.
+// Of the three slots the producer owns one (back), the consumer owns one (front) and
+// the third sits in between. publish() swaps back with the middle slot; acquire()
+// swaps the middle slot with front if something new was published since. Neither side
+// ever waits, the consumer always gets the newest complete value and skips any it was
+// too slow for, and slots are reused, so values that keep their capacity (vectors
+// cleared rather than reallocated) are handed over without allocating.
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer side: fill back(), then publish() it.
+    T& back() { return slots[backIndex]; }
+
+    void publish() {
+        std::uint8_t previous = middle.exchange(static_cast<std::uint8_t>(backIndex | kFresh), std::memory_order_acq_rel);
+        backIndex = previous & kIndexMask;
+    }
+
+    // Consumer side: true if front() now holds a newer value.
+    bool acquire() {
+        if ((middle.load(std::memory_order_acquire) & kFresh) == 0) {
+            return false;
+        }
+        std::uint8_t previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = previous & kIndexMask;
+        return true;
+    }
+
+    const T& front() const { return slots[frontIndex]; }
+
+private:
+    static constexpr std::uint8_t kIndexMask = 3;
+    static constexpr std::uint8_t kFresh = 4;
+
+    T slots[3];
+    // Each index is only touched by its own side; the middle index moves between them
+    std::uint8_t backIndex = 0;
+    std::uint8_t frontIndex = 1;
+    std::atomic<std::uint8_t> middle{2};
+};
+
+#endif
@@ -0,0 +1,88 @@
+// worker_pool.cpp
+#include "worker_pool.h"
+
+#include "profiler.h"
+
+WorkerPool::WorkerPool(unsigned threadCount) {
+    workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned WorkerPool::getThreadCount() const {
+    return static_cast<unsigned>(workers.size());
+}
+
+void WorkerPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& task) {
+    if (workers.empty() || count <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        taskCount = count;
+        nextIndex.store(0);
+        ++generation;
+    }
+    wake.notify_all();
+
+    drain(task);
+
+    // Every index has been claimed once drain() returns; wait for workers still running theirs,
+    // then retire the task so a late-waking worker cannot pick up a dangling pointer.
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return busyWorkers == 0; });
+    currentTask = nullptr;
+    taskCount = 0;
+}
+
+void WorkerPool::workerLoop() {
+    setProfileThreadName("worker");
+    std::size_t seenGeneration = 0;
+    for (;;) {
+        const std::function<void(std::size_t)>* task = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seenGeneration] { return stopping || generation != seenGeneration; });
+            if (stopping) {
+                return;
+            }
+            seenGeneration = generation;
+            task = currentTask;
+            if (task == nullptr) {
+                continue;
+            }
+            ++busyWorkers;
+        }
+
+        drain(*task);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busyWorkers;
+        }
+        done.notify_all();
+    }
+}
+
+void WorkerPool::drain(const std::function<void(std::size_t)>& task) {
+    for (std::size_t i = nextIndex.fetch_add(1); i < taskCount; i = nextIndex.fetch_add(1)) {
+        task(i);
+    }
+}
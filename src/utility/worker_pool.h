@@ -0,0 +1,43 @@
+// worker_pool.h
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for fork/join style work inside a tick.
+// parallelFor() hands out task indices to the workers and the calling thread,
+// and only returns once every index has finished.
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned threadCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned getThreadCount() const;
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& task);
+
+private:
+    void workerLoop();
+    void drain(const std::function<void(std::size_t)>& task);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(std::size_t)>* currentTask = nullptr;
+    std::size_t taskCount = 0;
+    std::atomic<std::size_t> nextIndex{0};
+    std::size_t generation = 0;
+    int busyWorkers = 0;
+    bool stopping = false;
+};
+
+#endif